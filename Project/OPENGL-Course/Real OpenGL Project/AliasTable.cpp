@@ -0,0 +1,41 @@
+#include "AliasTable.h"
+
+void AliasTable::Build(const float* weights, int count)
+{
+	probability.assign(count, 1.0f);
+	alias.resize(count);
+	for (int i = 0; i < count; i++) alias[i] = i;
+
+	totalWeight = 0.0;
+	for (int i = 0; i < count; i++)
+		if (weights[i] > 0.0f) totalWeight += weights[i];
+	if (count == 0 || totalWeight <= 0.0) return;
+
+	// Scale so the average bucket holds exactly 1, then pair each under-full bucket with an over-full one
+	std::vector<double> scaled(count);
+	std::vector<int> small, large;
+	small.reserve(count);
+	large.reserve(count);
+	double scale = (double)count / totalWeight;
+	for (int i = 0; i < count; i++)
+	{
+		scaled[i] = weights[i] > 0.0f ? weights[i] * scale : 0.0;
+		(scaled[i] < 1.0 ? small : large).push_back(i);
+	}
+
+	while (!small.empty() && !large.empty())
+	{
+		int s = small.back(); small.pop_back();
+		int l = large.back(); large.pop_back();
+
+		probability[s] = (float)scaled[s];
+		alias[s] = l;
+
+		scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+		(scaled[l] < 1.0 ? small : large).push_back(l);
+	}
+
+	// Leftovers are full buckets up to rounding error
+	for (int i : large) probability[i] = 1.0f;
+	for (int i : small) probability[i] = 1.0f;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+
+// Walker/Vose alias table: draws index i with probability weights[i] / sum(weights) in O(1).
+// Built once in O(n); sampling needs two uniforms and one table lookup.
+class AliasTable
+{
+public:
+	// Negative weights count as zero. An all-zero table falls back to uniform sampling.
+	void Build(const float* weights, int count);
+
+	// u0, u1 uniform in [0, 1)
+	int Sample(float u0, float u1) const
+	{
+		int n = (int)probability.size();
+		int i = (int)(u0 * (float)n);
+		if (i >= n) i = n - 1;
+		return u1 < probability[i] ? i : alias[i];
+	}
+
+	int GetSize() const { return (int)probability.size(); }
+	bool IsEmpty() const { return probability.empty(); }
+	double GetTotalWeight() const { return totalWeight; }
+
+private:
+	std::vector<float> probability;
+	std::vector<int> alias;
+	double totalWeight = 0.0;
+};
@@ -37,6 +37,7 @@ bool Application::Init()
 
 	// Renderer (shaders + skybox)
 	renderer.Init();
+	renderer.SetTerrainStreamer(&terrainStreamer);
 
 	std::vector<std::string> skyboxFaces;
 	skyboxFaces.push_back("Assets/Textures/Skybox/cupertin-lake_rt.tga");
@@ -153,6 +154,12 @@ void Application::Run()
 		glfwPollEvents();
 		inputHandler.UpdateCamera(mainWindow, camera, deltaTime);
 
+		// Apply finished background graph runs (mesh uploads and spawning need the GL thread)
+		nodeGraph.Update(sceneManager, &plainTexture, &plainMaterial);
+
+		// Stream terrain chunks around the camera (uploads are budgeted per frame)
+		terrainStreamer.Update(camera.getCameraPosition());
+
 		// Get live framebuffer size
 		int fbw, fbh;
 		glfwGetFramebufferSize(mainWindow.getWindow(), &fbw, &fbh);
@@ -185,6 +192,9 @@ void Application::Run()
 		glClearColor(0.12f, 0.12f, 0.12f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+		// Instanced batches are shared by the shadow passes and the main pass
+		renderer.BuildInstanceBatches(sceneManager);
+
 		// Shadow passes
 		renderer.DirectionalShadowMapPass(&mainLight, sceneManager);
 		for (unsigned int i = 0; i < pointLightCount; i++)
@@ -206,7 +216,8 @@ void Application::Run()
 		editorUI.Render(sceneManager, projection, view, camera.getCameraPosition(), viewportTexture, &camera);
 		
 		assetBrowser.Render(sceneManager, &uiState.isAssetBrowserOpen, uiState.forceLayout);
-		nodeEditorUI.Render(nodeGraph, sceneManager, &plainTexture, &plainMaterial, &uiState.isNodeEditorOpen, uiState.forceLayout);
+		nodeEditorUI.Render(nodeGraph, sceneManager, &uiState.isNodeEditorOpen, uiState.forceLayout);
+		terrainStreamer.RenderUI(&uiState.isTerrainStreamingOpen);
 
 		// Editor picking & gizmo (AFTER UI so "Scene" window exists)
 		inputHandler.UpdateEditor(mainWindow, camera, sceneManager, projection, editorUI);
@@ -262,6 +273,9 @@ void Application::SetupDockSpace()
 
 void Application::Shutdown()
 {
+	// Chunk meshes need the GL context, which is gone by the time members are destroyed
+	terrainStreamer.Clear();
+
 	if (viewportFBO) glDeleteFramebuffers(1, &viewportFBO);
 	if (viewportTexture) glDeleteTextures(1, &viewportTexture);
 	if (viewportDepth) glDeleteRenderbuffers(1, &viewportDepth);
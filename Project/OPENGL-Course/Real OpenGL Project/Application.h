@@ -10,6 +10,7 @@
 #include "DebugOverlay.h"
 #include "NodeGraph.h"
 #include "NodeEditorUI.h"
+#include "TerrainStreamer.h"
 #include "Texture.h"
 #include "Material.h"
 #include "DirectionalLight.h"
@@ -43,6 +44,7 @@ private:
 	DebugOverlay debugOverlay;
 	NodeGraph nodeGraph;
 	NodeEditorUI nodeEditorUI;
+	TerrainStreamer terrainStreamer;
 
 	// Resources
 	Texture plainTexture;
@@ -0,0 +1,77 @@
+#include "BufferPool.h"
+#include <new>
+
+BufferPool& BufferPool::Get()
+{
+	static BufferPool instance;
+	return instance;
+}
+
+BufferPool::~BufferPool()
+{
+	Trim(0);
+}
+
+int BufferPool::BucketIndex(size_t bytes)
+{
+	int index = 0;
+	while (index < BUCKET_COUNT && BucketSize(index) < bytes)
+		index++;
+	return index; // BUCKET_COUNT means "too large to pool"
+}
+
+void* BufferPool::Allocate(size_t bytes)
+{
+	if (bytes < MIN_POOLED_BYTES)
+		return ::operator new(bytes);
+
+	int index = BucketIndex(bytes);
+	if (index == BUCKET_COUNT)
+		return ::operator new(bytes);
+
+	Bucket& bucket = buckets[index];
+	{
+		std::lock_guard<std::mutex> lock(bucket.mutex);
+		if (!bucket.blocks.empty())
+		{
+			void* block = bucket.blocks.back();
+			bucket.blocks.pop_back();
+			cachedBytes.fetch_sub(BucketSize(index));
+			return block;
+		}
+	}
+	return ::operator new(BucketSize(index));
+}
+
+void BufferPool::Release(void* block, size_t bytes)
+{
+	if (!block) return;
+
+	int index = bytes < MIN_POOLED_BYTES ? BUCKET_COUNT : BucketIndex(bytes);
+	if (index == BUCKET_COUNT || cachedBytes.load() + BucketSize(index) > MAX_CACHED_BYTES)
+	{
+		::operator delete(block);
+		return;
+	}
+
+	Bucket& bucket = buckets[index];
+	std::lock_guard<std::mutex> lock(bucket.mutex);
+	bucket.blocks.push_back(block);
+	cachedBytes.fetch_add(BucketSize(index));
+}
+
+void BufferPool::Trim(size_t keepBytes)
+{
+	// Largest blocks go first: they hold the most memory and are the cheapest to re-create per byte
+	for (int index = BUCKET_COUNT - 1; index >= 0 && cachedBytes.load() > keepBytes; index--)
+	{
+		Bucket& bucket = buckets[index];
+		std::lock_guard<std::mutex> lock(bucket.mutex);
+		while (!bucket.blocks.empty() && cachedBytes.load() > keepBytes)
+		{
+			::operator delete(bucket.blocks.back());
+			bucket.blocks.pop_back();
+			cachedBytes.fetch_sub(BucketSize(index));
+		}
+	}
+}
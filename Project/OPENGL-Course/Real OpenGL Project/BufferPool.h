@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+// Size-bucketed recycler for the large, short-lived buffers produced while the node graph executes
+// (mesh streams, pin copies, normal/adjacency scratch). Blocks of 4 KB and up are rounded to a power
+// of two and, when released, parked in their bucket instead of going back to the heap, so repeated
+// executes of the same graph run almost allocation-free once warm. Small requests bypass the pool.
+// Thread-safe; one mutex per bucket.
+class BufferPool
+{
+public:
+	static BufferPool& Get();
+
+	void* Allocate(size_t bytes);
+	void Release(void* block, size_t bytes);
+
+	// Return cached blocks to the heap until at most 'keepBytes' remain parked
+	void Trim(size_t keepBytes);
+
+	size_t GetCachedBytes() const { return cachedBytes.load(); }
+
+	static const size_t MIN_POOLED_BYTES = 4096;
+	static const size_t MAX_CACHED_BYTES = (size_t)1 << 30; // never park more than this
+
+private:
+	BufferPool() = default;
+	~BufferPool();
+
+	static const int MIN_BUCKET_SHIFT = 12;
+	static const int BUCKET_COUNT = 28; // 4 KB .. 512 GB
+
+	struct Bucket
+	{
+		std::mutex mutex;
+		std::vector<void*> blocks;
+	};
+
+	Bucket buckets[BUCKET_COUNT];
+	std::atomic<size_t> cachedBytes{ 0 };
+
+	static int BucketIndex(size_t bytes);
+	static size_t BucketSize(int index) { return (size_t)1 << (index + MIN_BUCKET_SHIFT); }
+};
+
+// Standard allocator over BufferPool, stateless so containers using it swap/move/compare freely
+template <typename T>
+struct PoolAllocator
+{
+	using value_type = T;
+
+	PoolAllocator() = default;
+	template <typename U> PoolAllocator(const PoolAllocator<U>&) {}
+
+	T* allocate(size_t n) { return static_cast<T*>(BufferPool::Get().Allocate(n * sizeof(T))); }
+	void deallocate(T* p, size_t n) { BufferPool::Get().Release(p, n * sizeof(T)); }
+
+	template <typename U> bool operator==(const PoolAllocator<U>&) const { return true; }
+	template <typename U> bool operator!=(const PoolAllocator<U>&) const { return false; }
+};
+
+template <typename T>
+using PooledVector = std::vector<T, PoolAllocator<T>>;
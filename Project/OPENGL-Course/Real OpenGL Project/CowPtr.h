@@ -0,0 +1,46 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+
+// Reference-counted copy-on-write handle.
+// Copies share one immutable buffer; Write() detaches a private copy only when it is shared,
+// so passing data along links or through untouched pins is O(1).
+template <typename T>
+class CowPtr
+{
+public:
+	CowPtr() = default;
+	CowPtr(const T& value) : ptr(std::make_shared<T>(value)) {}
+	CowPtr(T&& value) : ptr(std::make_shared<T>(std::move(value))) {}
+
+	// Read access (an empty handle reads as a default-constructed T)
+	const T& Get() const { return ptr ? *ptr : Empty(); }
+	const T& operator*() const { return Get(); }
+	const T* operator->() const { return &Get(); }
+
+	// Mutable access, cloning the buffer first if anyone else still references it
+	T& Write()
+	{
+		if (!ptr)
+			ptr = std::make_shared<T>();
+		else if (ptr.use_count() > 1)
+			ptr = std::make_shared<T>(*ptr);
+		return *ptr;
+	}
+
+	void Reset() { ptr.reset(); }
+	bool IsNull() const { return ptr == nullptr; }
+
+	// True if both handles point at the same buffer (cheap identity check for caches)
+	bool SharesWith(const CowPtr& other) const { return ptr == other.ptr; }
+
+private:
+	std::shared_ptr<T> ptr;
+
+	static const T& Empty()
+	{
+		static const T empty{};
+		return empty;
+	}
+};
@@ -44,6 +44,7 @@ public:
 		bool isAssetBrowserOpen = true;
 		bool isNodeEditorOpen = true;
 		bool isDebugOverlayOpen = true;
+		bool isTerrainStreamingOpen = false;
 		bool forceLayout = false;
 	} windowState;
 
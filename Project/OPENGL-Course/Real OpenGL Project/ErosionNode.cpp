@@ -0,0 +1,285 @@
+#include "ErosionNode.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+void ErosionNode::RenderContent(SceneManager* scene)
+{
+	ImGui::PushID(this);
+
+	bool changed = false;
+	changed |= ImGui::SliderInt("Iterations", &iterations, 1, 5000);
+	changed |= ImGui::DragFloat("Time Budget (ms)", &timeBudgetMs, 10.0f, 0.0f, 600000.0f);
+	int ran = iterationsRun->load();
+	if (ran >= 0 && ran < iterations)
+		ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.2f, 1.0f), "Time budget hit: ran %d / %d iterations", ran, iterations);
+	changed |= ImGui::InputInt("Seed", &seed);
+	ImGui::SameLine();
+	if (ImGui::Button("Rand"))
+	{
+		seed = (int)(std::random_device{}() & 0x7fffffff);
+		changed = true;
+	}
+
+	ImGui::Separator();
+	ImGui::Text("Hydraulic");
+	changed |= ImGui::DragFloat("Rain", &rainRate, 0.001f, 0.0f, 1.0f);
+	changed |= ImGui::DragFloat("Evaporation", &evaporation, 0.001f, 0.0f, 1.0f);
+	changed |= ImGui::DragFloat("Capacity", &sedimentCapacity, 0.01f, 0.0f, 10.0f);
+	changed |= ImGui::DragFloat("Erosion", &erosionRate, 0.01f, 0.0f, 1.0f);
+	changed |= ImGui::DragFloat("Deposition", &depositionRate, 0.01f, 0.0f, 1.0f);
+
+	ImGui::Separator();
+	ImGui::Text("Thermal");
+	changed |= ImGui::DragFloat("Talus Angle", &talusAngle, 0.5f, 0.0f, 89.0f);
+	changed |= ImGui::DragFloat("Thermal Rate", &thermalRate, 0.01f, 0.0f, 1.0f);
+
+	if (changed) MarkDirty();
+
+	ImGui::PopID();
+}
+
+// Stateless per-cell random in [0, 1): same value for (seed, iteration, cell) on any thread
+static inline float CellRandom(unsigned int seed, unsigned int iteration, unsigned int cell)
+{
+	unsigned int h = seed * 0x9E3779B1u ^ iteration * 0x85EBCA77u ^ cell * 0xC2B2AE3Du;
+	h ^= h >> 16; h *= 0x7FEB352Du;
+	h ^= h >> 15; h *= 0x846CA68Bu;
+	h ^= h >> 16;
+	return (float)(h >> 8) * (1.0f / 16777216.0f);
+}
+
+void ErosionNode::Execute()
+{
+	outputs[0].data.Clear();
+	outputs[0].data.type = PinDataType::Heightfield;
+
+	if (inputs[0].data.type != PinDataType::Heightfield || inputs[0].data.heightfield->IsEmpty()) return;
+
+	const HeightfieldData& source = inputs[0].data.heightfield.Get();
+	const int W = source.samplesX;
+	const int H = source.samplesZ;
+	const size_t N = (size_t)W * H;
+	const float lx = source.GetSpacingX();
+	const float lz = source.GetSpacingZ();
+	const float cellArea = lx * lz;
+
+	// Solver state, one plane per quantity
+	PooledVector<float> terrain(source.heights.begin(), source.heights.end());
+	PooledVector<float> terrainNext(N);
+	PooledVector<float> water(N, 0.0f), sediment(N, 0.0f), sedimentNext(N);
+	PooledVector<float> fluxL(N, 0.0f), fluxR(N, 0.0f), fluxT(N, 0.0f), fluxB(N, 0.0f);
+	PooledVector<float> velX(N, 0.0f), velZ(N, 0.0f);
+	PooledVector<float> thermalOut(N), thermalExcess(N);
+
+	// Rows are split into bands of roughly 16k cells
+	ThreadPool& pool = ThreadPool::Get();
+	const int rowGrain = std::max(1, 16384 / W);
+	auto forRows = [&](const std::function<void(int, int)>& body) { pool.ParallelFor(0, H, rowGrain, body); };
+
+	const float talus = std::tan(glm::radians(talusAngle));
+	static const int nx[8] = { -1, 1, 0, 0, -1, 1, -1, 1 };
+	static const int nz[8] = { 0, 0, -1, 1, -1, -1, 1, 1 };
+	const float ndist[8] = { lx, lx, lz, lz,
+		std::sqrt(lx * lx + lz * lz), std::sqrt(lx * lx + lz * lz), std::sqrt(lx * lx + lz * lz), std::sqrt(lx * lx + lz * lz) };
+
+	auto start = std::chrono::steady_clock::now();
+	int iter = 0;
+	for (; iter < iterations; iter++)
+	{
+		if (IsCancelled()) return;
+		ReportProgress((float)iter / (float)iterations);
+		if (timeBudgetMs > 0.0f && iter > 0)
+		{
+			float elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+			if (elapsed > timeBudgetMs) break;
+		}
+
+		// 1. Rain
+		forRows([&](int z0, int z1)
+		{
+			for (int z = z0; z < z1; z++)
+				for (int x = 0; x < W; x++)
+				{
+					size_t i = (size_t)z * W + x;
+					water[i] += DT * rainRate * (0.5f + CellRandom((unsigned int)seed, (unsigned int)iter, (unsigned int)i));
+				}
+		});
+
+		// 2. Outflow flux through virtual pipes to the 4 neighbours, scaled so no cell drains below zero
+		forRows([&](int z0, int z1)
+		{
+			for (int z = z0; z < z1; z++)
+				for (int x = 0; x < W; x++)
+				{
+					size_t i = (size_t)z * W + x;
+					float h = terrain[i] + water[i];
+					auto pipe = [&](float flux, int ox, int oz, float length)
+					{
+						int x2 = x + ox, z2 = z + oz;
+						if (x2 < 0 || x2 >= W || z2 < 0 || z2 >= H) return 0.0f;
+						size_t j = (size_t)z2 * W + x2;
+						float dh = h - (terrain[j] + water[j]);
+						return std::max(0.0f, flux + DT * GRAVITY * dh / length);
+					};
+					float fl = pipe(fluxL[i], -1, 0, lx);
+					float fr = pipe(fluxR[i], 1, 0, lx);
+					float ft = pipe(fluxT[i], 0, -1, lz);
+					float fb = pipe(fluxB[i], 0, 1, lz);
+
+					float total = (fl + fr + ft + fb) * DT;
+					float k = total > 0.0f ? std::min(1.0f, water[i] * cellArea / total) : 0.0f;
+					fluxL[i] = fl * k; fluxR[i] = fr * k; fluxT[i] = ft * k; fluxB[i] = fb * k;
+				}
+		});
+
+		// 3. Water volume and velocity from net flux
+		forRows([&](int z0, int z1)
+		{
+			for (int z = z0; z < z1; z++)
+				for (int x = 0; x < W; x++)
+				{
+					size_t i = (size_t)z * W + x;
+					float inL = x > 0 ? fluxR[i - 1] : 0.0f;
+					float inR = x < W - 1 ? fluxL[i + 1] : 0.0f;
+					float inT = z > 0 ? fluxB[i - W] : 0.0f;
+					float inB = z < H - 1 ? fluxT[i + W] : 0.0f;
+					float outflow = fluxL[i] + fluxR[i] + fluxT[i] + fluxB[i];
+
+					float before = water[i];
+					float after = std::max(0.0f, before + DT * (inL + inR + inT + inB - outflow) / cellArea);
+					water[i] = after;
+
+					float depth = 0.5f * (before + after);
+					if (depth > 1e-5f)
+					{
+						velX[i] = 0.5f * (inL - fluxL[i] + fluxR[i] - inR) / (depth * lz);
+						velZ[i] = 0.5f * (inT - fluxT[i] + fluxB[i] - inB) / (depth * lx);
+					}
+					else
+					{
+						velX[i] = 0.0f;
+						velZ[i] = 0.0f;
+					}
+				}
+		});
+
+		// 4. Erosion / deposition against the flow's carrying capacity
+		forRows([&](int z0, int z1)
+		{
+			for (int z = z0; z < z1; z++)
+				for (int x = 0; x < W; x++)
+				{
+					size_t i = (size_t)z * W + x;
+					int xa = std::max(x - 1, 0), xb = std::min(x + 1, W - 1);
+					int za = std::max(z - 1, 0), zb = std::min(z + 1, H - 1);
+					float dhdx = (terrain[(size_t)z * W + xb] - terrain[(size_t)z * W + xa]) / ((xb - xa) * lx);
+					float dhdz = (terrain[(size_t)zb * W + x] - terrain[(size_t)za * W + x]) / ((zb - za) * lz);
+					float slope = std::sqrt(dhdx * dhdx + dhdz * dhdz);
+					float sinTilt = std::max(0.05f, slope / std::sqrt(1.0f + slope * slope));
+
+					// Clamped to one cell per step (CFL) so near-dry cells cannot produce runaway capacity
+					float speed = std::min(std::sqrt(velX[i] * velX[i] + velZ[i] * velZ[i]), std::min(lx, lz) / DT);
+					float capacity = sedimentCapacity * sinTilt * speed;
+
+					float b = terrain[i];
+					float s = sediment[i];
+					if (capacity > s)
+					{
+						float amount = erosionRate * (capacity - s) * DT;
+						b -= amount;
+						s += amount;
+					}
+					else
+					{
+						float amount = depositionRate * (s - capacity) * DT;
+						b += amount;
+						s -= amount;
+					}
+					terrainNext[i] = b;
+					sediment[i] = s;
+				}
+		});
+		terrain.swap(terrainNext);
+
+		// 5. Sediment transport (semi-Lagrangian: fetch from upstream) and evaporation
+		forRows([&](int z0, int z1)
+		{
+			for (int z = z0; z < z1; z++)
+				for (int x = 0; x < W; x++)
+				{
+					size_t i = (size_t)z * W + x;
+					float sx = std::min(std::max((float)x - velX[i] * DT / lx, 0.0f), (float)(W - 1));
+					float sz = std::min(std::max((float)z - velZ[i] * DT / lz, 0.0f), (float)(H - 1));
+					int x0 = std::min((int)sx, W - 2), z0i = std::min((int)sz, H - 2);
+					float fx = sx - (float)x0, fz = sz - (float)z0i;
+					size_t j = (size_t)z0i * W + x0;
+					float top = sediment[j] + (sediment[j + 1] - sediment[j]) * fx;
+					float bottom = sediment[j + W] + (sediment[j + W + 1] - sediment[j + W]) * fx;
+					sedimentNext[i] = top + (bottom - top) * fz;
+
+					water[i] *= (1.0f - evaporation * DT);
+				}
+		});
+		sediment.swap(sedimentNext);
+
+		// 6. Thermal: material above the talus slope slides to lower neighbours.
+		// First each cell decides how much it sheds, then each cell gathers what its neighbours shed to it.
+		forRows([&](int z0, int z1)
+		{
+			for (int z = z0; z < z1; z++)
+				for (int x = 0; x < W; x++)
+				{
+					size_t i = (size_t)z * W + x;
+					float sum = 0.0f, maxExcess = 0.0f;
+					for (int n = 0; n < 8; n++)
+					{
+						int x2 = x + nx[n], z2 = z + nz[n];
+						if (x2 < 0 || x2 >= W || z2 < 0 || z2 >= H) continue;
+						float excess = terrain[i] - terrain[(size_t)z2 * W + x2] - talus * ndist[n];
+						if (excess > 0.0f)
+						{
+							sum += excess;
+							maxExcess = std::max(maxExcess, excess);
+						}
+					}
+					thermalOut[i] = 0.5f * thermalRate * maxExcess;
+					thermalExcess[i] = sum;
+				}
+		});
+		forRows([&](int z0, int z1)
+		{
+			for (int z = z0; z < z1; z++)
+				for (int x = 0; x < W; x++)
+				{
+					size_t i = (size_t)z * W + x;
+					float h = terrain[i] - thermalOut[i];
+					for (int n = 0; n < 8; n++)
+					{
+						int x2 = x + nx[n], z2 = z + nz[n];
+						if (x2 < 0 || x2 >= W || z2 < 0 || z2 >= H) continue;
+						size_t j = (size_t)z2 * W + x2;
+						if (thermalExcess[j] <= 0.0f) continue;
+						// Neighbour j's share towards this cell (the pair is symmetric in distance)
+						float excess = terrain[j] - terrain[i] - talus * ndist[n];
+						if (excess > 0.0f)
+							h += thermalOut[j] * excess / thermalExcess[j];
+					}
+					terrainNext[i] = h;
+				}
+		});
+		terrain.swap(terrainNext);
+	}
+
+	iterationsRun->store(iter);
+
+	// Sediment still in suspension settles where it is
+	HeightfieldData& result = outputs[0].data.heightfield.Write();
+	result.Resize(W, H, source.origin, source.size);
+	for (size_t i = 0; i < N; i++)
+		result.heights[i] = terrain[i] + sediment[i];
+
+	outputs[0].data.sourceObjectName = inputs[0].data.sourceObjectName;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "NodeGraph.h"
+#include "imgui.h"
+
+// Erodes a heightfield with a grid-based hydraulic solver (virtual-pipe water flow, sediment
+// pickup/deposit and semi-Lagrangian transport) followed by a thermal slope-collapse pass.
+// Input: Heightfield, Output: Heightfield
+//
+// Every pass reads the previous state and writes only its own cells, so row bands run in parallel
+// and the result depends only on the seed and the number of iterations, never on the thread count.
+// The optional time budget (off by default) gives that up: it stops after however many iterations
+// fit, so the output then depends on machine speed. The node shows how many actually ran.
+class ErosionNode : public GraphNode
+{
+public:
+	ErosionNode(NodeGraph& graph)
+	{
+		id = graph.NextNodeId();
+		title = "Erosion";
+
+		Pin heightIn(graph.NextPinId(), PinDataType::Heightfield, "Heightfield");
+		inputs.push_back(heightIn);
+
+		Pin heightOut(graph.NextPinId(), PinDataType::Heightfield, "Heightfield");
+		outputs.push_back(heightOut);
+	}
+
+	void RenderContent(SceneManager* scene) override;
+	void Execute() override;
+	GraphNode* Clone() const override { return new ErosionNode(*this); }
+
+private:
+	int iterations = 200;
+	float timeBudgetMs = 0.0f; // Stops early once exceeded (0 = no limit)
+	int seed = 1;
+
+	// Hydraulic
+	float rainRate = 0.012f;
+	float evaporation = 0.02f;
+	float sedimentCapacity = 1.0f;
+	float erosionRate = 0.3f;
+	float depositionRate = 0.3f;
+
+	// Thermal
+	float talusAngle = 35.0f; // Degrees
+	float thermalRate = 0.3f;
+
+	// Iterations completed by the last run (-1 = none yet). Shared with execution clones so the
+	// count from a background run reaches the node drawn in the editor.
+	std::shared_ptr<std::atomic<int>> iterationsRun = std::make_shared<std::atomic<int>>(-1);
+
+	// Solver time step (fixed so results do not depend on frame rate)
+	static constexpr float DT = 0.02f;
+	static constexpr float GRAVITY = 9.81f;
+};
@@ -1,4 +1,5 @@
 #include "GameObject.h"
+#include <algorithm>
 
 GameObject::GameObject()
 	: name("GameObject"), model(nullptr), mesh(nullptr), texture(nullptr), normalMap(nullptr), material(nullptr)
@@ -107,6 +108,26 @@ void GameObject::RemoveChild(GameObject* child)
 	}
 }
 
+void GameObject::AdoptChildren(const std::vector<GameObject*>& newChildren)
+{
+	children.reserve(children.size() + newChildren.size());
+	for (auto* child : newChildren) {
+		if (!child) continue;
+		children.push_back(child);
+		child->parent = this;
+	}
+}
+
+void GameObject::RemoveChildren(const std::unordered_set<GameObject*>& removed)
+{
+	auto keepEnd = std::remove_if(children.begin(), children.end(), [&](GameObject* c) {
+		if (!removed.count(c)) return false;
+		c->parent = nullptr;
+		return true;
+	});
+	children.erase(keepEnd, children.end());
+}
+
 void GameObject::Render(GLint uniformModel, GLint uniformSpecularIntensity, GLint uniformShininess, GLint uniformMaterialColor, GLint uniformUseNormalMap, GLint uniformUseDiffuseTexture, const glm::mat4& parentMatrix)
 {
 	// Apply transform relative to parent
@@ -132,6 +153,15 @@ void GameObject::Render(GLint uniformModel, GLint uniformSpecularIntensity, GLin
 	else {
 		modelMatrix = parentMatrix * localModel;
 	}
+
+	// Drawn by the Renderer's instanced path; only the children still render from here
+	if (drawnInstanced)
+	{
+		for (auto* child : children)
+			child->Render(uniformModel, uniformSpecularIntensity, uniformShininess, uniformMaterialColor, uniformUseNormalMap, uniformUseDiffuseTexture, modelMatrix);
+		return;
+	}
+
 	glUniformMatrix4fv(uniformModel, 1, GL_FALSE, glm::value_ptr(modelMatrix));
 
 	// Apply material if available
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <unordered_set>
 #include <GL/glew.h>
 #include <glm/gtc/type_ptr.hpp>
 
@@ -46,17 +47,31 @@ public:
 	void AddChild(GameObject* child);
 	void RemoveChild(GameObject* child);
 
+	// Bulk hierarchy edits (used by SceneManager::AddObjects / RemoveObjects): one pass over 'children'
+	// instead of one scan per child. AdoptChildren expects parentless objects not already attached.
+	void AdoptChildren(const std::vector<GameObject*>& newChildren);
+	void RemoveChildren(const std::unordered_set<GameObject*>& removed);
+
+	// Spawn ownership: objects created by a generator carry its handle (0 = user object)
+	void SetSpawnOwner(unsigned int owner) { spawnOwner = owner; }
+	unsigned int GetSpawnOwner() const { return spawnOwner; }
+
 	void SetInheritScale(bool inherit) { inheritScale = inherit; }
 	bool GetInheritScale() const { return inheritScale; }
 
+	// Set each frame by the Renderer when this object is drawn through an instanced batch
+	void SetDrawnInstanced(bool instanced) { drawnInstanced = instanced; }
+	bool IsDrawnInstanced() const { return drawnInstanced; }
+
 	// Render this object
 	void Render(GLint uniformModel, GLint uniformSpecularIntensity, GLint uniformShininess, GLint uniformMaterialColor, GLint uniformUseNormalMap, GLint uniformUseDiffuseTexture, const glm::mat4& parentMatrix = glm::mat4(1.0f));
 
 	// Mesh Persistence
-	void SetCPUMeshData(const MeshData& data) { cpuMeshData = data; hasCustomMesh = true; }
-	const MeshData& GetCPUMeshData() const { return cpuMeshData; }
+	void SetCPUMeshData(const CowPtr<MeshData>& data) { cpuMeshData = data; hasCustomMesh = true; }
+	const MeshData& GetCPUMeshData() const { return cpuMeshData.Get(); }
+	const CowPtr<MeshData>& GetSharedCPUMeshData() const { return cpuMeshData; }
 	bool HasCustomMesh() const { return hasCustomMesh; }
-	void ClearCustomMesh() { hasCustomMesh = false; cpuMeshData.Clear(); }
+	void ClearCustomMesh() { hasCustomMesh = false; cpuMeshData.Reset(); }
 
 private:
 	std::string name;
@@ -65,6 +80,8 @@ private:
 	GameObject* parent = nullptr;
 	std::vector<GameObject*> children;
 	bool inheritScale = true;
+	bool drawnInstanced = false;
+	unsigned int spawnOwner = 0;
 
 	Model* model;      // For loaded .obj models
 	Mesh* mesh;        // For primitive meshes
@@ -74,7 +91,7 @@ private:
 	Texture* normalMap;
 	Material* material;
 
-	// Persistent mesh data for procedural generation
-	MeshData cpuMeshData;
+	// Persistent mesh data for procedural generation (shared with the graph's pin buffers)
+	CowPtr<MeshData> cpuMeshData;
 	bool hasCustomMesh = false;
 };
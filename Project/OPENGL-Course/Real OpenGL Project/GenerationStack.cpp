@@ -62,7 +62,7 @@ void GenerationStack::Execute(SceneManager& scene, Texture* defaultTex, Material
 	}
 
 	// Convert final result to a scene object
-	if (hasData && !currentData.vertices.empty())
+	if (hasData && !currentData.IsEmpty())
 	{
 		Mesh* mesh = currentData.ToMesh();
 		if (mesh)
@@ -13,8 +13,9 @@ public:
 	// Display name shown in the Pipeline UI
 	virtual std::string GetName() const = 0;
 
-	// Render ImGui parameter controls for this generator
-	virtual void RenderUI() = 0;
+	// Render ImGui parameter controls for this generator.
+	// Returns true if any parameter was changed this frame.
+	virtual bool RenderUI() = 0;
 
 	// Execute the generator.
 	// 'input' is nullptr for the first generator in the stack,
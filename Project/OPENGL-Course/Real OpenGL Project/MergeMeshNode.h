@@ -27,18 +27,26 @@ public:
 		ImGui::Text("Combines two mesh inputs.");
 	}
 
-	void Execute(SceneManager& scene) override
+	GraphNode* Clone() const override { return new MergeMeshNode(*this); }
+
+	void Execute() override
 	{
 		outputs[0].data.Clear();
 		outputs[0].data.type = PinDataType::Mesh;
 
-		MeshData& meshA = inputs[0].data.meshData;
-		MeshData& meshB = inputs[1].data.meshData;
-
-		MeshData result = meshA;
-		result.Append(meshB);
-
-		outputs[0].data.meshData = result;
+		// Start from a shared reference to A; only a non-empty B forces a private copy
+		const MeshData& meshB = inputs[1].data.meshData.Get();
+
+		if (inputs[0].data.meshData->IsEmpty())
+		{
+			outputs[0].data.meshData = inputs[1].data.meshData;
+		}
+		else
+		{
+			outputs[0].data.meshData = inputs[0].data.meshData;
+			if (!meshB.IsEmpty())
+				outputs[0].data.meshData.Write().Append(meshB);
+		}
 
 		// Propagate source name: Prefer latest (B), fallback to first (A)
 		std::string target = inputs[1].data.sourceObjectName;
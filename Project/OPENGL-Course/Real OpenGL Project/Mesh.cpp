@@ -1,5 +1,7 @@
 #include "Mesh.h"
 #include "DebugOverlay.h"
+#include <cstddef>
+#include <vector>
 
 Mesh::Mesh()
 {
@@ -7,9 +9,10 @@ Mesh::Mesh()
 	VBO = 0;
 	IBO = 0;
 	indexCount = 0;
+	indexType = GL_UNSIGNED_INT;
 }
 
-void Mesh::CreateMesh(GLfloat* vertices, unsigned int* indices, unsigned int numberOfVertices, unsigned int numberOfIndices)
+void Mesh::CreateBuffers(const void* vertexData, GLsizeiptr vertexBytes, unsigned int vertexCount, unsigned int* indices, unsigned int numberOfIndices)
 {
 	ClearMesh();
 	
@@ -23,14 +26,30 @@ void Mesh::CreateMesh(GLfloat* vertices, unsigned int* indices, unsigned int num
 	// generate the index buffer object and bind it
 	glGenBuffers(1, &IBO);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices[0]) * numberOfIndices, indices, GL_STATIC_DRAW);
+	if (vertexCount <= 65536)
+	{
+		// Small meshes (primitives, rocks, most scatter prototypes) only need half the index memory
+		std::vector<GLushort> shortIndices(indices, indices + numberOfIndices);
+		indexType = GL_UNSIGNED_SHORT;
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort) * numberOfIndices, shortIndices.data(), GL_STATIC_DRAW);
+	}
+	else
+	{
+		indexType = GL_UNSIGNED_INT;
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices[0]) * numberOfIndices, indices, GL_STATIC_DRAW);
+	}
 
 	// generate vertex buffer object(the DATA itself)
 	glGenBuffers(1, &VBO); 
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
 	// add the vertices that i have to the vbo
 	// static = never changing vertices data
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices[0]) * numberOfVertices, vertices, GL_STATIC_DRAW); 
+	glBufferData(GL_ARRAY_BUFFER, vertexBytes, vertexData, GL_STATIC_DRAW); 
+}
+
+void Mesh::CreateMesh(GLfloat* vertices, unsigned int* indices, unsigned int numberOfVertices, unsigned int numberOfIndices)
+{
+	CreateBuffers(vertices, sizeof(vertices[0]) * numberOfVertices, numberOfVertices / 14, indices, numberOfIndices);
 
 	// function that tells the GPU how to interpret vertex data stored in a vertex buffer object (VBO)
 	// glVertexAttribPointer parameters:
@@ -68,6 +87,38 @@ void Mesh::CreateMesh(GLfloat* vertices, unsigned int* indices, unsigned int num
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); // unbind IBO
 }
 
+void Mesh::CreateMesh(const CompactVertex* vertices, unsigned int vertexCount, unsigned int* indices, unsigned int numberOfIndices)
+{
+	CreateBuffers(vertices, sizeof(CompactVertex) * vertexCount, vertexCount, indices, numberOfIndices);
+
+	const GLsizei stride = sizeof(CompactVertex);
+
+	// position
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(CompactVertex, position));
+	glEnableVertexAttribArray(0);
+
+	// uv as half floats
+	glVertexAttribPointer(1, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)offsetof(CompactVertex, uv));
+	glEnableVertexAttribArray(1);
+
+	// normal / tangent: signed normalized 10:10:10:2, read back as vec4 in [-1, 1]
+	glVertexAttribPointer(2, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void*)offsetof(CompactVertex, normal));
+	glEnableVertexAttribArray(2);
+
+	glVertexAttribPointer(3, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void*)offsetof(CompactVertex, tangent));
+	glEnableVertexAttribArray(3);
+
+	// No bitangent stream: location 4 stays disabled and reads the constant (0,0,0), which tells
+	// the shaders to rebuild it from cross(normal, tangent.xyz) * tangent.w
+	glDisableVertexAttribArray(4);
+	glVertexAttrib3f(4, 0.0f, 0.0f, 0.0f);
+
+	// unbinds
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
 void Mesh::RenderMesh()
 {
 	// use this VAO
@@ -75,7 +126,7 @@ void Mesh::RenderMesh()
 	// bind index buffer object
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO); 
 	// draw the object stored in the VAO
-	glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0); 
+	glDrawElements(GL_TRIANGLES, indexCount, indexType, 0); 
 	
 	// Track stats
 	if (DebugOverlay::GetInstance()) {
@@ -89,6 +140,36 @@ void Mesh::RenderMesh()
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); 
 }
 
+void Mesh::RenderMeshInstanced(GLuint instanceBuffer, GLintptr byteOffset, GLsizei instanceCount)
+{
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+
+	// A mat4 attribute takes four vec4 locations; divisor 1 advances it once per instance instead of per vertex
+	glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+	for (GLuint i = 0; i < 4; i++)
+	{
+		glVertexAttribPointer(5 + i, 4, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * 16, (void*)(byteOffset + sizeof(GLfloat) * 4 * i));
+		glVertexAttribDivisor(5 + i, 1);
+		glEnableVertexAttribArray(5 + i);
+	}
+
+	glDrawElementsInstanced(GL_TRIANGLES, indexCount, indexType, 0, instanceCount);
+
+	// Track stats
+	if (DebugOverlay::GetInstance()) {
+		DebugOverlay::GetInstance()->CountDrawCall();
+		DebugOverlay::GetInstance()->CountTriangles((indexCount / 3) * instanceCount);
+	}
+
+	// Leave the VAO as RenderMesh expects it
+	for (GLuint i = 0; i < 4; i++)
+		glDisableVertexAttribArray(5 + i);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
 void Mesh::ClearMesh()
 {
 	if (IBO != 0)
@@ -110,6 +191,7 @@ void Mesh::ClearMesh()
 	}
 
 	indexCount = 0;
+	indexType = GL_UNSIGNED_INT;
 }
 
 Mesh::~Mesh()
@@ -2,22 +2,43 @@
 
 #include <GL\glew.h>
 
+// Packed 24-byte vertex (vs. 56 bytes for the 14-float layout):
+// float3 position, half2 UV, normal and tangent as signed-normalized 10:10:10:2.
+// The tangent's 2-bit w holds the handedness, so the bitangent is rebuilt in the shader.
+struct CompactVertex
+{
+	GLfloat position[3];
+	GLuint uv;      // two GL_HALF_FLOATs
+	GLuint normal;  // GL_INT_2_10_10_10_REV
+	GLuint tangent; // GL_INT_2_10_10_10_REV, w = +-1
+};
+
 class Mesh
 {
 public:
 	Mesh();
 
 	void CreateMesh(GLfloat* vertices, unsigned int* indices, unsigned int numberOfVertices, unsigned int numberOfIndices);
+	// Same, from packed vertices ('vertexCount' is the number of vertices, not floats)
+	void CreateMesh(const CompactVertex* vertices, unsigned int vertexCount, unsigned int* indices, unsigned int numberOfIndices);
 	void RenderMesh();
+	// Draw 'instanceCount' copies using world matrices read from 'instanceBuffer' at 'byteOffset' (locations 5-8)
+	void RenderMeshInstanced(GLuint instanceBuffer, GLintptr byteOffset, GLsizei instanceCount);
 	void ClearMesh();
 
 	GLuint GetVAO() { return VAO; }
 	GLuint GetIBO() { return IBO; }
 	GLuint GetIndexCount() { return indexCount; }
+	GLenum GetIndexType() { return indexType; } // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
 
 	~Mesh();
 
 private:
 	GLuint VAO, VBO, IBO;
+
+	// Generates and binds the VAO, IBO and VBO (left bound for the attribute setup).
+	// Indices are narrowed to 16 bits when every vertex is addressable with them.
+	void CreateBuffers(const void* vertexData, GLsizeiptr vertexBytes, unsigned int vertexCount, unsigned int* indices, unsigned int numberOfIndices);
 	GLsizei indexCount;
+	GLenum indexType;
 };
\ No newline at end of file
@@ -3,8 +3,16 @@
 #include <vector>
 #include <GL/glew.h>
 #include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
 #include <string>
 #include "Mesh.h"
+#include "CowPtr.h"
+#include "MeshKernels.h"
+#include "ThreadPool.h"
+#include "BufferPool.h"
+#include <algorithm>
+#include <memory>
+#include <mutex>
 
 // ========== Transform Data ==========
 struct TransformData
@@ -13,6 +21,7 @@ struct TransformData
 	glm::vec3 rotation = glm::vec3(0.0f); // Euler degrees
 	glm::vec3 scale = glm::vec3(1.0f);
 	glm::vec3 normal = glm::vec3(0.0f, 1.0f, 0.0f);
+	int prototype = 0; // Index into PinData::prototypes for instance lists
 };
 
 using TransformList = std::vector<TransformData>;
@@ -22,43 +31,192 @@ enum class PinDataType
 {
 	None,
 	Mesh,
-	TransformList
+	TransformList,
+	Heightfield
 };
 
 // ========== CPU-side Mesh Data ==========
-// Vertex layout: pos(3) + uv(2) + normal(3) + tangent(3) + bitangent(3) = 14 floats
+// One complete vertex, for builders that produce whole vertices at a time
+struct MeshVertex
+{
+	glm::vec3 position = glm::vec3(0.0f);
+	glm::vec2 uv = glm::vec2(0.0f);
+	glm::vec3 normal = glm::vec3(0.0f, 1.0f, 0.0f);
+	glm::vec3 tangent = glm::vec3(1.0f, 0.0f, 0.0f);
+	glm::vec3 bitangent = glm::vec3(0.0f, 0.0f, 1.0f);
+};
+
+// Raw pointers into a block of vertices appended by MeshData::AppendVertices.
+// Valid until the streams grow again; index 0 is vertex 'baseVertex' of the mesh.
+struct VertexWriter
+{
+	glm::vec3* positions;
+	glm::vec2* uvs;
+	glm::vec3* normals;
+	glm::vec3* tangents;
+	glm::vec3* bitangents;
+	int baseVertex;
+
+	void Set(int i, const MeshVertex& v)
+	{
+		positions[i] = v.position;
+		uvs[i] = v.uv;
+		normals[i] = v.normal;
+		tangents[i] = v.tangent;
+		bitangents[i] = v.bitangent;
+	}
+};
+
+// Structure-of-arrays: one typed stream per attribute, so passes that only touch positions
+// (displacement, scale bakes) stream 12 bytes per vertex instead of the full vertex.
+// GPU vertices are produced only at upload time (UploadTo / ToMesh), either packed into
+// 24-byte CompactVertex records (default) or as the 14-float pos/uv/normal/tangent/bitangent layout.
 struct MeshData
 {
-	std::vector<GLfloat> vertices;
-	std::vector<unsigned int> indices;
+	// Streams come from BufferPool, so the copies and temporaries made during graph execution
+	// recycle earlier blocks instead of hitting the heap
+	PooledVector<glm::vec3> positions;
+	PooledVector<glm::vec2> uvs;
+	PooledVector<glm::vec3> normals;
+	PooledVector<glm::vec3> tangents;
+	PooledVector<glm::vec3> bitangents;
+	PooledVector<unsigned int> indices;
 
-	// Upload to GPU and return a new Mesh
-	Mesh* ToMesh() const
+	// Optional per-vertex weight in [0, 1] (e.g. a scatter density mask). Empty means every vertex
+	// weighs 1; once present it is kept the same length as the other streams. Never uploaded.
+	PooledVector<float> weights;
+
+	static const int INTERLEAVED_STRIDE = 14; // floats per vertex in the GPU buffer
+
+	// Build the interleaved GPU vertex buffer
+	PooledVector<GLfloat> Interleave() const
 	{
-		if (vertices.empty() || indices.empty()) return nullptr;
+		int count = GetVertexCount();
+		PooledVector<GLfloat> out((size_t)count * INTERLEAVED_STRIDE);
+		for (int i = 0; i < count; i++)
+		{
+			GLfloat* v = &out[(size_t)i * INTERLEAVED_STRIDE];
+			v[0] = positions[i].x;   v[1] = positions[i].y;   v[2] = positions[i].z;
+			v[3] = uvs[i].x;         v[4] = uvs[i].y;
+			v[5] = normals[i].x;     v[6] = normals[i].y;     v[7] = normals[i].z;
+			v[8] = tangents[i].x;    v[9] = tangents[i].y;    v[10] = tangents[i].z;
+			v[11] = bitangents[i].x; v[12] = bitangents[i].y; v[13] = bitangents[i].z;
+		}
+		return out;
+	}
 
-		Mesh* mesh = new Mesh();
+	// Build the packed GPU vertex buffer (see CompactVertex)
+	PooledVector<CompactVertex> PackCompact() const
+	{
+		int count = GetVertexCount();
+		PooledVector<CompactVertex> out(count);
+		for (int i = 0; i < count; i++)
+		{
+			CompactVertex& v = out[i];
+			v.position[0] = positions[i].x;
+			v.position[1] = positions[i].y;
+			v.position[2] = positions[i].z;
+			v.uv = glm::packHalf2x16(uvs[i]);
+			v.normal = glm::packSnorm3x10_1x2(glm::vec4(normals[i], 0.0f));
+
+			// Handedness of the original frame; a missing bitangent counts as right-handed
+			float handedness = glm::dot(glm::cross(normals[i], tangents[i]), bitangents[i]) < 0.0f ? -1.0f : 1.0f;
+			v.tangent = glm::packSnorm3x10_1x2(glm::vec4(tangents[i], handedness));
+		}
+		return out;
+	}
+
+	// (Re)fill an existing Mesh, reusing its GL objects' slot in the scene
+	void UploadTo(Mesh* mesh, bool compact = true) const
+	{
+		if (compact)
+		{
+			PooledVector<CompactVertex> packed = PackCompact();
+			mesh->CreateMesh(
+				packed.data(),
+				(unsigned int)packed.size(),
+				const_cast<unsigned int*>(indices.data()),
+				(unsigned int)indices.size()
+			);
+			return;
+		}
+
+		PooledVector<GLfloat> interleaved = Interleave();
 		mesh->CreateMesh(
-			const_cast<GLfloat*>(vertices.data()),
+			interleaved.data(),
 			const_cast<unsigned int*>(indices.data()),
-			(unsigned int)vertices.size(),
+			(unsigned int)interleaved.size(),
 			(unsigned int)indices.size()
 		);
+	}
+
+	// Upload to GPU and return a new Mesh
+	Mesh* ToMesh(bool compact = true) const
+	{
+		if (IsEmpty() || indices.empty()) return nullptr;
+
+		Mesh* mesh = new Mesh();
+		UploadTo(mesh, compact);
 		return mesh;
 	}
 
-	// Helper: add a vertex (14 floats)
+	void Reserve(int vertexCount, int indexCount)
+	{
+		positions.reserve(vertexCount);
+		uvs.reserve(vertexCount);
+		normals.reserve(vertexCount);
+		tangents.reserve(vertexCount);
+		bitangents.reserve(vertexCount);
+		if (HasWeights()) weights.reserve(vertexCount);
+		indices.reserve(indexCount);
+	}
+
+	// Helper: add a vertex (one entry per stream)
 	void AddVertex(float px, float py, float pz,
 		float u, float v,
 		float nx, float ny, float nz,
 		float tx, float ty, float tz,
 		float bx, float by, float bz)
 	{
-		vertices.push_back(px); vertices.push_back(py); vertices.push_back(pz);
-		vertices.push_back(u);  vertices.push_back(v);
-		vertices.push_back(nx); vertices.push_back(ny); vertices.push_back(nz);
-		vertices.push_back(tx); vertices.push_back(ty); vertices.push_back(tz);
-		vertices.push_back(bx); vertices.push_back(by); vertices.push_back(bz);
+		positions.emplace_back(px, py, pz);
+		uvs.emplace_back(u, v);
+		normals.emplace_back(nx, ny, nz);
+		tangents.emplace_back(tx, ty, tz);
+		bitangents.emplace_back(bx, by, bz);
+		if (HasWeights()) weights.push_back(1.0f);
+	}
+
+	void AddVertex(const MeshVertex& v)
+	{
+		positions.push_back(v.position);
+		uvs.push_back(v.uv);
+		normals.push_back(v.normal);
+		tangents.push_back(v.tangent);
+		bitangents.push_back(v.bitangent);
+		if (HasWeights()) weights.push_back(1.0f);
+	}
+
+	// Bulk append: grow every stream by 'count' and return pointers to the new (uninitialised) block.
+	// Callers fill it directly instead of paying push_back bookkeeping per attribute.
+	VertexWriter AppendVertices(int count)
+	{
+		int base = GetVertexCount();
+		size_t newSize = (size_t)base + count;
+		positions.resize(newSize);
+		uvs.resize(newSize);
+		normals.resize(newSize);
+		tangents.resize(newSize);
+		bitangents.resize(newSize);
+		if (HasWeights()) weights.resize(newSize, 1.0f);
+		return { &positions[base], &uvs[base], &normals[base], &tangents[base], &bitangents[base], base };
+	}
+
+	// Bulk append of 'count' indices, returned for the caller to fill
+	unsigned int* AppendIndices(int count)
+	{
+		size_t base = indices.size();
+		indices.resize(base + count);
+		return indices.data() + base;
 	}
 
 	// Helper: add a triangle (3 indices)
@@ -69,90 +227,249 @@ struct MeshData
 		indices.push_back(i2);
 	}
 
+	static const int TRANSFORM_GRAIN = 16384; // vertices per parallel chunk
+
 	void TransformBy(const glm::mat4& matrix)
 	{
 		glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(matrix)));
-		int count = GetVertexCount();
-		for (int i = 0; i < count; i++)
+		ThreadPool::Get().ParallelFor(0, GetVertexCount(), TRANSFORM_GRAIN, [&](int begin, int end)
 		{
-			int base = i * 14;
-			// Position
-			glm::vec4 p = matrix * glm::vec4(vertices[base], vertices[base + 1], vertices[base + 2], 1.0f);
-			vertices[base] = p.x;
-			vertices[base + 1] = p.y;
-			vertices[base + 2] = p.z;
-
-			// Normal
-			glm::vec3 n = glm::normalize(normalMatrix * glm::vec3(vertices[base + 5], vertices[base + 6], vertices[base + 7]));
-			vertices[base + 5] = n.x;
-			vertices[base + 6] = n.y;
-			vertices[base + 7] = n.z;
-
-			// Tangent
-			glm::vec3 t = glm::normalize(normalMatrix * glm::vec3(vertices[base + 8], vertices[base + 9], vertices[base + 10]));
-			vertices[base + 8] = t.x;
-			vertices[base + 9] = t.y;
-			vertices[base + 10] = t.z;
-
-			// Bitangent
-			glm::vec3 b = glm::normalize(normalMatrix * glm::vec3(vertices[base + 11], vertices[base + 12], vertices[base + 13]));
-			vertices[base + 11] = b.x;
-			vertices[base + 12] = b.y;
-			vertices[base + 13] = b.z;
-		}
+			int n = end - begin;
+			MeshKernels::TransformPoints(matrix, &positions[begin], &positions[begin], n);
+			MeshKernels::TransformDirections(normalMatrix, &normals[begin], &normals[begin], n);
+			MeshKernels::TransformDirections(normalMatrix, &tangents[begin], &tangents[begin], n);
+			MeshKernels::TransformDirections(normalMatrix, &bitangents[begin], &bitangents[begin], n);
+		});
+	}
+
+	// Append 'instanceCount' copies of 'prototype', copy i transformed by matrices[i].
+	// Storage is sized once and instances are baked in parallel, each into its own slice.
+	void AppendInstances(const MeshData& prototype, const glm::mat4* matrices, int instanceCount)
+	{
+		int srcVerts = prototype.GetVertexCount();
+		int srcIndices = (int)prototype.indices.size();
+		if (srcVerts == 0 || instanceCount <= 0) return;
+
+		if (prototype.HasWeights()) EnsureWeights();
+		VertexWriter w = AppendVertices(srcVerts * instanceCount);
+		unsigned int* idx = AppendIndices(srcIndices * instanceCount);
+
+		int grain = std::max(1, TRANSFORM_GRAIN / srcVerts);
+		ThreadPool::Get().ParallelFor(0, instanceCount, grain, [&](int begin, int end)
+		{
+			for (int i = begin; i < end; i++)
+			{
+				const glm::mat4& m = matrices[i];
+				glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(m)));
+				int v0 = i * srcVerts;
+
+				MeshKernels::TransformPoints(m, prototype.positions.data(), w.positions + v0, srcVerts);
+				std::copy(prototype.uvs.begin(), prototype.uvs.end(), w.uvs + v0);
+				MeshKernels::TransformDirections(normalMatrix, prototype.normals.data(), w.normals + v0, srcVerts);
+				MeshKernels::TransformDirections(normalMatrix, prototype.tangents.data(), w.tangents + v0, srcVerts);
+				MeshKernels::TransformDirections(normalMatrix, prototype.bitangents.data(), w.bitangents + v0, srcVerts);
+				if (prototype.HasWeights())
+					std::copy(prototype.weights.begin(), prototype.weights.end(), weights.begin() + (w.baseVertex + v0));
+
+				unsigned int* dst = idx + (size_t)i * srcIndices;
+				unsigned int base = (unsigned int)(w.baseVertex + v0);
+				for (int k = 0; k < srcIndices; k++)
+					dst[k] = prototype.indices[k] + base;
+			}
+		});
 	}
 
 	void Append(const MeshData& other)
 	{
-		if (other.vertices.empty()) return;
+		if (other.IsEmpty()) return;
 
 		int baseVertex = GetVertexCount();
 		
 		// Append vertices
-		vertices.insert(vertices.end(), other.vertices.begin(), other.vertices.end());
-		
-		// Append indices with offset
-		for (unsigned int idx : other.indices)
+		positions.insert(positions.end(), other.positions.begin(), other.positions.end());
+		uvs.insert(uvs.end(), other.uvs.begin(), other.uvs.end());
+		normals.insert(normals.end(), other.normals.begin(), other.normals.end());
+		tangents.insert(tangents.end(), other.tangents.begin(), other.tangents.end());
+		bitangents.insert(bitangents.end(), other.bitangents.begin(), other.bitangents.end());
+		if (other.HasWeights())
 		{
-			indices.push_back(idx + baseVertex);
+			EnsureWeights(baseVertex);
+			weights.insert(weights.end(), other.weights.begin(), other.weights.end());
 		}
+		else if (HasWeights())
+		{
+			weights.resize(GetVertexCount(), 1.0f);
+		}
+		
+		// Append indices with offset (sized once, then written in place)
+		int indexCount = (int)other.indices.size();
+		unsigned int* dst = AppendIndices(indexCount);
+		for (int i = 0; i < indexCount; i++)
+			dst[i] = other.indices[i] + baseVertex;
 	}
 
 	// Get position of vertex at index
-	glm::vec3 GetPosition(int vertIndex) const
-	{
-		int base = vertIndex * 14;
-		return glm::vec3(vertices[base], vertices[base + 1], vertices[base + 2]);
-	}
+	glm::vec3 GetPosition(int vertIndex) const { return positions[vertIndex]; }
 
 	// Get normal of vertex at index
-	glm::vec3 GetNormal(int vertIndex) const
+	glm::vec3 GetNormal(int vertIndex) const { return normals[vertIndex]; }
+
+	bool HasWeights() const { return !weights.empty(); }
+	float GetWeight(int vertIndex) const { return weights.empty() ? 1.0f : weights[vertIndex]; }
+
+	// Materialise the weight stream (all 1) for the first 'vertexCount' vertices if it is missing
+	void EnsureWeights(int vertexCount)
 	{
-		int base = vertIndex * 14;
-		return glm::vec3(vertices[base + 5], vertices[base + 6], vertices[base + 7]);
+		if (weights.empty()) weights.assign(vertexCount, 1.0f);
 	}
+	void EnsureWeights() { EnsureWeights(GetVertexCount()); }
 
-	int GetVertexCount() const { return (int)vertices.size() / 14; }
+	int GetVertexCount() const { return (int)positions.size(); }
 	int GetTriangleCount() const { return (int)indices.size() / 3; }
+	bool IsEmpty() const { return positions.empty(); }
+
+	void Clear()
+	{
+		positions.clear();
+		uvs.clear();
+		normals.clear();
+		tangents.clear();
+		bitangents.clear();
+		indices.clear();
+		weights.clear();
+	}
+};
+
+// ========== Heightfield ==========
+// Regular grid of heights over an XZ rectangle. Terrain generators write this directly: one float
+// per sample instead of a full mesh vertex. It is expanded by ToMeshData() only where a Mesh pin
+// consumes it (see PinData::GetHeightfieldMesh).
+struct HeightfieldData
+{
+	int samplesX = 0;                   // Grid points along X (quads = samplesX - 1)
+	int samplesZ = 0;                   // Grid points along Z
+	glm::vec2 origin = glm::vec2(0.0f); // World XZ of sample (0, 0)
+	glm::vec2 size = glm::vec2(0.0f);   // World XZ extents
+	PooledVector<float> heights;        // Row-major: z * samplesX + x
+
+	void Resize(int countX, int countZ, const glm::vec2& gridOrigin, const glm::vec2& gridSize)
+	{
+		samplesX = countX;
+		samplesZ = countZ;
+		origin = gridOrigin;
+		size = gridSize;
+		heights.assign((size_t)countX * countZ, 0.0f);
+	}
+
+	bool IsEmpty() const { return samplesX < 2 || samplesZ < 2 || heights.empty(); }
+
+	float GetSpacingX() const { return size.x / (float)(samplesX - 1); }
+	float GetSpacingZ() const { return size.y / (float)(samplesZ - 1); }
+
+	float& At(int x, int z) { return heights[(size_t)z * samplesX + x]; }
+	float At(int x, int z) const { return heights[(size_t)z * samplesX + x]; }
+
+	// Height slopes (dh/dx, dh/dz) from central differences, one-sided on the borders
+	glm::vec2 GetSlope(int x, int z) const
+	{
+		int x0 = x > 0 ? x - 1 : x, x1 = x < samplesX - 1 ? x + 1 : x;
+		int z0 = z > 0 ? z - 1 : z, z1 = z < samplesZ - 1 ? z + 1 : z;
+		return glm::vec2(
+			(At(x1, z) - At(x0, z)) / ((float)(x1 - x0) * GetSpacingX()),
+			(At(x, z1) - At(x, z0)) / ((float)(z1 - z0) * GetSpacingZ()));
+	}
+
+	glm::vec3 GetNormal(int x, int z) const
+	{
+		glm::vec2 slope = GetSlope(x, z);
+		return glm::normalize(glm::vec3(-slope.x, 1.0f, -slope.y));
+	}
+
+	// Expand into a triangle mesh (same layout and winding as PrimitiveGenerator::GetPlaneData),
+	// rows filled in parallel
+	MeshData ToMeshData() const
+	{
+		MeshData mesh;
+		if (IsEmpty()) return mesh;
+
+		VertexWriter w = mesh.AppendVertices(samplesX * samplesZ);
+		float dx = GetSpacingX(), dz = GetSpacingZ();
+		ThreadPool::Get().ParallelFor(0, samplesZ, 16, [&](int begin, int end)
+		{
+			for (int z = begin; z < end; z++)
+			{
+				for (int x = 0; x < samplesX; x++)
+				{
+					int v = z * samplesX + x;
+					glm::vec2 slope = GetSlope(x, z);
+					w.positions[v] = glm::vec3(origin.x + x * dx, At(x, z), origin.y + z * dz);
+					w.uvs[v] = glm::vec2((float)x / (float)(samplesX - 1), (float)z / (float)(samplesZ - 1));
+					w.normals[v] = glm::normalize(glm::vec3(-slope.x, 1.0f, -slope.y));
+					w.tangents[v] = glm::normalize(glm::vec3(1.0f, slope.x, 0.0f));
+					w.bitangents[v] = glm::normalize(glm::vec3(0.0f, slope.y, 1.0f));
+				}
+			}
+		});
+
+		unsigned int* idx = mesh.AppendIndices((samplesX - 1) * (samplesZ - 1) * 6);
+		for (int z = 0; z < samplesZ - 1; z++)
+		{
+			for (int x = 0; x < samplesX - 1; x++)
+			{
+				unsigned int topLeft = z * samplesX + x;
+				unsigned int topRight = topLeft + 1;
+				unsigned int bottomLeft = (z + 1) * samplesX + x;
+				unsigned int bottomRight = bottomLeft + 1;
 
-	void Clear() { vertices.clear(); indices.clear(); }
+				*idx++ = topLeft; *idx++ = bottomLeft; *idx++ = topRight;
+				*idx++ = topRight; *idx++ = bottomLeft; *idx++ = bottomRight;
+			}
+		}
+		return mesh;
+	}
 };
 
 // ========== Tagged union for data flowing between nodes ==========
+// Payloads are shared copy-on-write buffers: copying a PinData (link propagation, pass-through
+// outputs) only bumps reference counts. Use Write() on a member before mutating it.
 struct PinData
 {
 	PinDataType type = PinDataType::None;
-	MeshData meshData;
-	TransformList transforms;
-	std::vector<MeshData> instanceMeshes;
+	CowPtr<MeshData> meshData;
+	CowPtr<TransformList> transforms;
+	std::vector<CowPtr<MeshData>> prototypes; // Unique instance meshes, referenced by TransformData::prototype
+	CowPtr<HeightfieldData> heightfield;
 	std::string sourceObjectName = "(none)";
 
+	// Mesh expansion of the heightfield, built by the first Mesh consumer and shared by every copy
+	// of this payload, so each producer output is expanded once and consumers see the same buffer
+	struct HeightfieldMeshCache
+	{
+		std::mutex mutex;
+		CowPtr<HeightfieldData> source;
+		CowPtr<MeshData> mesh;
+	};
+	std::shared_ptr<HeightfieldMeshCache> heightfieldMesh = std::make_shared<HeightfieldMeshCache>();
+
+	CowPtr<MeshData> GetHeightfieldMesh() const
+	{
+		std::lock_guard<std::mutex> lock(heightfieldMesh->mutex);
+		if (heightfieldMesh->mesh.IsNull() || !heightfieldMesh->source.SharesWith(heightfield))
+		{
+			heightfieldMesh->source = heightfield;
+			heightfieldMesh->mesh = heightfield->ToMeshData();
+		}
+		return heightfieldMesh->mesh;
+	}
+
 	void Clear()
 	{
 		type = PinDataType::None;
-		meshData.Clear();
-		transforms.clear();
-		instanceMeshes.clear();
+		meshData.Reset();
+		transforms.Reset();
+		heightfield.Reset();
+		prototypes.clear();
 		sourceObjectName = "(none)";
+		heightfieldMesh = std::make_shared<HeightfieldMeshCache>(); // Detach from copies of the old payload
 	}
 };
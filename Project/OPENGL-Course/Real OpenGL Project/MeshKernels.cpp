@@ -0,0 +1,121 @@
+#include "MeshKernels.h"
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define MESH_SIMD_SSE 1
+#include <xmmintrin.h>
+#endif
+
+// ========== Scalar ==========
+
+static inline void TransformPoint(const glm::mat4& m, const glm::vec3& s, glm::vec3& d)
+{
+	float x = s.x, y = s.y, z = s.z;
+	d.x = m[0][0] * x + m[1][0] * y + m[2][0] * z + m[3][0];
+	d.y = m[0][1] * x + m[1][1] * y + m[2][1] * z + m[3][1];
+	d.z = m[0][2] * x + m[1][2] * y + m[2][2] * z + m[3][2];
+}
+
+static inline void TransformDirection(const glm::mat3& m, const glm::vec3& s, glm::vec3& d)
+{
+	float x = m[0][0] * s.x + m[1][0] * s.y + m[2][0] * s.z;
+	float y = m[0][1] * s.x + m[1][1] * s.y + m[2][1] * s.z;
+	float z = m[0][2] * s.x + m[1][2] * s.y + m[2][2] * s.z;
+	float lenSq = x * x + y * y + z * z;
+	float inv = lenSq > 0.0f ? 1.0f / std::sqrt(lenSq) : 0.0f;
+	d.x = x * inv;
+	d.y = y * inv;
+	d.z = z * inv;
+}
+
+#ifdef MESH_SIMD_SSE
+// ========== SSE (4 vertices per iteration) ==========
+
+// Three registers holding x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3 -> one register per component
+static inline void Load4(const glm::vec3* p, __m128& x, __m128& y, __m128& z)
+{
+	const float* f = &p[0].x;
+	__m128 a = _mm_loadu_ps(f);
+	__m128 b = _mm_loadu_ps(f + 4);
+	__m128 c = _mm_loadu_ps(f + 8);
+
+	__m128 bc = _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 1, 0, 2));            // x2 y1 x3 z2
+	x = _mm_shuffle_ps(a, bc, _MM_SHUFFLE(2, 0, 3, 0));                    // x0 x1 x2 x3
+	y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+		_mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+	z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+		_mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+// Inverse of Load4
+static inline void Store4(glm::vec3* p, __m128 x, __m128 y, __m128 z)
+{
+	float* f = &p[0].x;
+	__m128 xyLo = _mm_unpacklo_ps(x, y); // x0 y0 x1 y1
+	__m128 xyHi = _mm_unpackhi_ps(x, y); // x2 y2 x3 y3
+
+	__m128 a = _mm_shuffle_ps(xyLo, _mm_shuffle_ps(z, xyLo, _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0));
+	__m128 b = _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), xyHi, _MM_SHUFFLE(1, 0, 2, 0));
+	__m128 c = _mm_shuffle_ps(_mm_shuffle_ps(z, xyHi, _MM_SHUFFLE(2, 2, 2, 2)),
+		_mm_shuffle_ps(xyHi, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+
+	_mm_storeu_ps(f, a);
+	_mm_storeu_ps(f + 4, b);
+	_mm_storeu_ps(f + 8, c);
+}
+#endif
+
+void MeshKernels::TransformPoints(const glm::mat4& m, const glm::vec3* src, glm::vec3* dst, int count)
+{
+	int i = 0;
+#ifdef MESH_SIMD_SSE
+	__m128 m00 = _mm_set1_ps(m[0][0]), m10 = _mm_set1_ps(m[1][0]), m20 = _mm_set1_ps(m[2][0]), m30 = _mm_set1_ps(m[3][0]);
+	__m128 m01 = _mm_set1_ps(m[0][1]), m11 = _mm_set1_ps(m[1][1]), m21 = _mm_set1_ps(m[2][1]), m31 = _mm_set1_ps(m[3][1]);
+	__m128 m02 = _mm_set1_ps(m[0][2]), m12 = _mm_set1_ps(m[1][2]), m22 = _mm_set1_ps(m[2][2]), m32 = _mm_set1_ps(m[3][2]);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x, y, z;
+		Load4(src + i, x, y, z);
+
+		__m128 rx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m10, y)), _mm_mul_ps(m20, z)), m30);
+		__m128 ry = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m01, x), _mm_mul_ps(m11, y)), _mm_mul_ps(m21, z)), m31);
+		__m128 rz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m02, x), _mm_mul_ps(m12, y)), _mm_mul_ps(m22, z)), m32);
+
+		Store4(dst + i, rx, ry, rz);
+	}
+#endif
+	for (; i < count; i++)
+		TransformPoint(m, src[i], dst[i]);
+}
+
+void MeshKernels::TransformDirections(const glm::mat3& m, const glm::vec3* src, glm::vec3* dst, int count)
+{
+	int i = 0;
+#ifdef MESH_SIMD_SSE
+	__m128 m00 = _mm_set1_ps(m[0][0]), m10 = _mm_set1_ps(m[1][0]), m20 = _mm_set1_ps(m[2][0]);
+	__m128 m01 = _mm_set1_ps(m[0][1]), m11 = _mm_set1_ps(m[1][1]), m21 = _mm_set1_ps(m[2][1]);
+	__m128 m02 = _mm_set1_ps(m[0][2]), m12 = _mm_set1_ps(m[1][2]), m22 = _mm_set1_ps(m[2][2]);
+	__m128 zero = _mm_setzero_ps();
+	__m128 one = _mm_set1_ps(1.0f);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x, y, z;
+		Load4(src + i, x, y, z);
+
+		__m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m10, y)), _mm_mul_ps(m20, z));
+		__m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m01, x), _mm_mul_ps(m11, y)), _mm_mul_ps(m21, z));
+		__m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m02, x), _mm_mul_ps(m12, y)), _mm_mul_ps(m22, z));
+
+		// Full-precision 1/sqrt (not rsqrt) so results match the scalar tail; masked to 0 for zero vectors
+		__m128 lenSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)), _mm_mul_ps(rz, rz));
+		__m128 nonZero = _mm_cmpgt_ps(lenSq, zero);
+		__m128 inv = _mm_and_ps(nonZero, _mm_div_ps(one, _mm_sqrt_ps(lenSq)));
+
+		Store4(dst + i, _mm_mul_ps(rx, inv), _mm_mul_ps(ry, inv), _mm_mul_ps(rz, inv));
+	}
+#endif
+	for (; i < count; i++)
+		TransformDirection(m, src[i], dst[i]);
+}
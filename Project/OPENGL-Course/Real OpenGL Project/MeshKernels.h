@@ -0,0 +1,17 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// Batched vertex transforms used by MeshData::TransformBy / AppendInstances.
+// Streams are processed four vertices per SSE instruction (12 floats load as three registers and are
+// transposed to x/y/z lanes), with a scalar tail and a scalar fallback on non-x86 targets.
+// 'src' may equal 'dst' for in-place transforms.
+class MeshKernels
+{
+public:
+	// dst[i] = vec3(m * vec4(src[i], 1))
+	static void TransformPoints(const glm::mat4& m, const glm::vec3* src, glm::vec3* dst, int count);
+
+	// dst[i] = normalize(m * src[i]); zero-length results stay zero instead of becoming NaN
+	static void TransformDirections(const glm::mat3& m, const glm::vec3* src, glm::vec3* dst, int count);
+};
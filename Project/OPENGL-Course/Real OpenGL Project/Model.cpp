@@ -41,15 +41,15 @@ void Model::LoadNode(aiNode* node, const aiScene* scene)
 
 void Model::LoadMesh(aiMesh* mesh, const aiScene* scene)
 {
-	std::vector<GLfloat> vertices;
-	std::vector<unsigned int> indices;
-
+	// CPU-side MeshData (one stream per attribute), also kept for node graph access
+	MeshData md;
+	md.Reserve((int)mesh->mNumVertices, (int)mesh->mNumFaces * 3);
 
 	// add vertices
 	for (size_t i = 0; i < mesh->mNumVertices; i++)
 	{
 		// x y z positions
-		vertices.insert(vertices.end(), { mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z });
+		md.positions.emplace_back(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
 		
 		// Update bounds
 		minBound.x = std::min(minBound.x, mesh->mVertices[i].x);
@@ -62,34 +62,34 @@ void Model::LoadMesh(aiMesh* mesh, const aiScene* scene)
 		// u v texture coordinates 
 		if (mesh->mTextureCoords[0])
 		{
-			vertices.insert(vertices.end(), { mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y });
+			md.uvs.emplace_back(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y);
 		}
 		else
 		{
-			vertices.insert(vertices.end(), { 0.0f, 0.0f });
+			md.uvs.emplace_back(0.0f, 0.0f);
 		}
 
 		// normals
-		vertices.insert(vertices.end(), { mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z });
+		md.normals.emplace_back(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z);
 
 		// tangents
 		if (mesh->mTangents)
 		{
-			vertices.insert(vertices.end(), { mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z });
+			md.tangents.emplace_back(mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z);
 		}
 		else
 		{
-			vertices.insert(vertices.end(), { 0.0f, 0.0f, 0.0f });
+			md.tangents.emplace_back(0.0f, 0.0f, 0.0f);
 		}
 
 		// bitangents
 		if (mesh->mBitangents)
 		{
-			vertices.insert(vertices.end(), { mesh->mBitangents[i].x, mesh->mBitangents[i].y, mesh->mBitangents[i].z });
+			md.bitangents.emplace_back(mesh->mBitangents[i].x, mesh->mBitangents[i].y, mesh->mBitangents[i].z);
 		}
 		else
 		{
-			vertices.insert(vertices.end(), { 0.0f, 0.0f, 0.0f });
+			md.bitangents.emplace_back(0.0f, 0.0f, 0.0f);
 		}
 	}
 
@@ -100,21 +100,17 @@ void Model::LoadMesh(aiMesh* mesh, const aiScene* scene)
 		aiFace face = mesh->mFaces[i];
 		for (size_t j = 0; j < face.mNumIndices; j++)
 		{
-			indices.push_back(face.mIndices[j]);
+			md.indices.push_back(face.mIndices[j]);
 		}
 	}
 
 	// create mesh and add to meshlist
 	Mesh* newMesh = new Mesh();
-	newMesh->CreateMesh(&vertices[0], &indices[0], (unsigned int)vertices.size(), (unsigned int)indices.size());
+	md.UploadTo(newMesh);
 	meshList.push_back(newMesh);
 	meshToTex.push_back(mesh->mMaterialIndex);
 
-	// Store CPU-side MeshData for node graph access
-	MeshData md;
-	md.vertices = vertices;
-	md.indices = indices;
-	meshDataList.push_back(md);
+	meshDataList.push_back(std::move(md));
 }
 
 void Model::LoadMaterials(const aiScene* scene)
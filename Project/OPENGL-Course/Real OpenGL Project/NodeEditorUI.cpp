@@ -1,6 +1,9 @@
 #include "NodeEditorUI.h"
 #include "NodeGraph.h"
 #include "PerlinNoiseNode.h"
+#include "PerlinTerrainNode.h"
+#include "ErosionNode.h"
+#include "ScatterMaskNode.h"
 #include "SceneInputNode.h"
 #include "ScatterNode.h"
 #include "MergeMeshNode.h"
@@ -19,7 +22,7 @@ NodeEditorUI::~NodeEditorUI()
 {
 }
 
-void NodeEditorUI::Render(NodeGraph& graph, SceneManager& scene, Texture* defaultTex, Material* defaultMat, bool* p_open, bool forceLayout)
+void NodeEditorUI::Render(NodeGraph& graph, SceneManager& scene, bool* p_open, bool forceLayout)
 {
 	if (p_open && !*p_open) return;
 	if (!p_open && !isOpen) return;
@@ -45,16 +48,28 @@ void NodeEditorUI::Render(NodeGraph& graph, SceneManager& scene, Texture* defaul
 		}
 		if (ImGui::BeginMenu("Execute"))
 		{
-			if (ImGui::MenuItem("Execute Graph")) { graph.Execute(scene, defaultTex, defaultMat); }
+			bool idle = !graph.IsExecuting();
+			if (ImGui::MenuItem("Execute Graph", nullptr, false, idle)) { graph.ExecuteAsync(scene); }
+			if (ImGui::MenuItem("Rebuild All", nullptr, false, idle)) { graph.MarkAllDirty(); graph.ExecuteAsync(scene); }
+			if (ImGui::MenuItem("Cancel", nullptr, false, !idle)) { graph.CancelExecution(); }
 			ImGui::EndMenu();
 		}
 		ImGui::EndMenuBar();
 	}
 
-	// Toolbar
-	if (ImGui::Button("Execute Graph"))
+	// Toolbar (results are applied by NodeGraph::Update from the main loop)
+	if (graph.IsExecuting())
 	{
-		graph.Execute(scene, defaultTex, defaultMat);
+		ImGui::ProgressBar(graph.GetProgress(), ImVec2(200.0f, 0.0f));
+		ImGui::SameLine();
+		if (ImGui::Button("Cancel"))
+		{
+			graph.CancelExecution();
+		}
+	}
+	else if (ImGui::Button("Execute Graph"))
+	{
+		graph.ExecuteAsync(scene);
 	}
 	ImGui::SameLine();
 	ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "|  Right-click to add nodes");
@@ -127,6 +142,26 @@ void NodeEditorUI::RenderNodes(NodeGraph& graph, SceneManager* scene)
 		// Minimalistic title bar
 		ImNodes::BeginNodeTitleBar();
 		ImGui::TextUnformatted(node->title.c_str());
+		switch (graph.GetNodeState(node->id))
+		{
+		case NodeRunState::Queued:
+			ImGui::SameLine();
+			ImGui::TextColored(ImVec4(0.6f, 0.6f, 0.6f, 1.0f), "(queued)");
+			break;
+		case NodeRunState::Running:
+			ImGui::ProgressBar(graph.GetNodeProgress(node->id), ImVec2(120.0f, 4.0f), "");
+			break;
+		case NodeRunState::Done:
+			ImGui::SameLine();
+			ImGui::TextColored(ImVec4(0.4f, 0.9f, 0.4f, 1.0f), "(done)");
+			break;
+		case NodeRunState::Cancelled:
+			ImGui::SameLine();
+			ImGui::TextColored(ImVec4(0.9f, 0.5f, 0.3f, 1.0f), "(cancelled)");
+			break;
+		default:
+			break;
+		}
 		ImNodes::EndNodeTitleBar();
 
 		// Interior Content (UI parameters)
@@ -147,9 +182,11 @@ void NodeEditorUI::RenderNodes(NodeGraph& graph, SceneManager* scene)
 			ImNodes::EndInputAttribute();
 		}
 
-		// Outputs
+		// Outputs (heightfield pins are tinted; they can still be linked to any mesh input)
 		for (auto& pin : node->outputs)
 		{
+			bool heightfieldPin = pin.dataType == PinDataType::Heightfield;
+			if (heightfieldPin) ImNodes::PushColorStyle(ImNodesCol_Pin, IM_COL32(110, 200, 120, 255));
 			ImNodes::BeginOutputAttribute(pin.id);
 			float textWidth = ImGui::CalcTextSize(pin.name.c_str()).x;
 			// Indent based on a fixed node width to avoid infinite expansion feedback loops
@@ -158,6 +195,7 @@ void NodeEditorUI::RenderNodes(NodeGraph& graph, SceneManager* scene)
 			ImGui::TextUnformatted(pin.name.c_str());
 			if (indent > 0.0f) ImGui::Unindent(indent);
 			ImNodes::EndOutputAttribute();
+			if (heightfieldPin) ImNodes::PopColorStyle();
 		}
 
 		ImNodes::EndNode();
@@ -185,9 +223,12 @@ void NodeEditorUI::HandleEditorInteractions(NodeGraph& graph)
 	{
 		GraphNode* newNode = nullptr;
 
+		if (ImGui::MenuItem("Perlin Terrain")) newNode = new PerlinTerrainNode(graph);
+		if (ImGui::MenuItem("Erosion")) newNode = new ErosionNode(graph);
 		if (ImGui::MenuItem("Perlin Noise")) newNode = new PerlinNoiseNode(graph);
 		if (ImGui::MenuItem("Scene Input")) newNode = new SceneInputNode(graph);
 		if (ImGui::MenuItem("Scatter")) newNode = new ScatterNode(graph);
+		if (ImGui::MenuItem("Scatter Mask")) newNode = new ScatterMaskNode(graph);
 		if (ImGui::MenuItem("Merge Mesh")) newNode = new MergeMeshNode(graph);
 		if (ImGui::MenuItem("Output")) newNode = new OutputNode(graph);
 
@@ -6,8 +6,6 @@
 
 class NodeGraph;
 class SceneManager;
-class Texture;
-class Material;
 
 // ImGui visual editor for the procedural generation NodeGraph.
 class NodeEditorUI
@@ -16,7 +14,7 @@ public:
 	NodeEditorUI();
 	~NodeEditorUI();
 
-	void Render(NodeGraph& graph, SceneManager& scene, Texture* defaultTex, Material* defaultMat, bool* p_open = nullptr, bool forceLayout = false);
+	void Render(NodeGraph& graph, SceneManager& scene, bool* p_open = nullptr, bool forceLayout = false);
 
 private:
 	bool isOpen;
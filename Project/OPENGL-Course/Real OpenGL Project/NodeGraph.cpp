@@ -7,11 +7,20 @@
 #include "PrimitiveGenerator.h"
 #include "Texture.h"
 #include "Material.h"
+#include "ThreadPool.h"
+#include "BufferPool.h"
 #include "imgui.h"
 
 #include <algorithm>
 #include <queue>
+#include <unordered_set>
 #include <set>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <functional>
 #include <cstdio>
 
 // ========== GraphNode ==========
@@ -51,6 +60,11 @@ NodeGraph::~NodeGraph()
 void NodeGraph::AddNode(GraphNode* node)
 {
 	nodes.push_back(node);
+	nodeIndex[node->id] = node;
+
+	// Pins are created in node constructors and never resized afterwards, so the pointers stay valid
+	for (auto& p : node->inputs) pinIndex[p.id] = { node, &p, false };
+	for (auto& p : node->outputs) pinIndex[p.id] = { node, &p, true };
 }
 
 void NodeGraph::RemoveNode(int nodeId)
@@ -59,59 +73,66 @@ void NodeGraph::RemoveNode(int nodeId)
 	GraphNode* node = FindNode(nodeId);
 	if (!node) return;
 
-	// Collect pin IDs
-	std::set<int> pinIds;
-	for (auto& p : node->inputs) pinIds.insert(p.id);
-	for (auto& p : node->outputs) pinIds.insert(p.id);
+	// Collect link IDs touching this node: outgoing from the adjacency list, incoming from the input index
+	std::vector<int> linkIds;
+	auto outIt = outgoingLinks.find(nodeId);
+	if (outIt != outgoingLinks.end())
+		for (auto& link : outIt->second) linkIds.push_back(link.id);
+	for (auto& p : node->inputs)
+	{
+		auto inIt = inputLinks.find(p.id);
+		if (inIt != inputLinks.end()) linkIds.push_back(inIt->second.id);
+	}
 
-	// Remove links touching these pins
-	links.erase(std::remove_if(links.begin(), links.end(),
-		[&pinIds](const Link& l) {
-			return pinIds.count(l.startPinId) || pinIds.count(l.endPinId);
-		}), links.end());
+	// Downstream nodes lose an input, so RemoveLink invalidates their cached results
+	for (int linkId : linkIds)
+		RemoveLink(linkId);
+
+	for (auto& p : node->inputs) pinIndex.erase(p.id);
+	for (auto& p : node->outputs) pinIndex.erase(p.id);
+	nodeIndex.erase(nodeId);
+	outgoingLinks.erase(nodeId);
 
 	// Remove the node
-	nodes.erase(std::remove_if(nodes.begin(), nodes.end(),
-		[nodeId](GraphNode* n) {
-			if (n->id == nodeId) { delete n; return true; }
-			return false;
-		}), nodes.end());
+	nodes.erase(std::remove(nodes.begin(), nodes.end(), node), nodes.end());
+	delete node;
 }
 
 GraphNode* NodeGraph::FindNode(int nodeId)
 {
-	for (auto* n : nodes)
-		if (n->id == nodeId) return n;
-	return nullptr;
+	auto it = nodeIndex.find(nodeId);
+	return it != nodeIndex.end() ? it->second : nullptr;
 }
 
 GraphNode* NodeGraph::FindNodeByPinId(int pinId)
 {
-	for (auto* n : nodes)
-	{
-		for (auto& p : n->inputs) if (p.id == pinId) return n;
-		for (auto& p : n->outputs) if (p.id == pinId) return n;
-	}
-	return nullptr;
+	auto it = pinIndex.find(pinId);
+	return it != pinIndex.end() ? it->second.node : nullptr;
+}
+
+Pin* NodeGraph::FindPinById(int pinId)
+{
+	auto it = pinIndex.find(pinId);
+	return it != pinIndex.end() ? it->second.pin : nullptr;
 }
 
 bool NodeGraph::CanLink(int outputPinId, int inputPinId)
 {
-	GraphNode* outNode = FindNodeByPinId(outputPinId);
-	GraphNode* inNode = FindNodeByPinId(inputPinId);
-	if (!outNode || !inNode) return false;
-	if (outNode == inNode) return false; // No self-links
+	auto outIt = pinIndex.find(outputPinId);
+	auto inIt = pinIndex.find(inputPinId);
+	if (outIt == pinIndex.end() || inIt == pinIndex.end()) return false;
 
-	Pin* outPin = outNode->FindOutputPin(outputPinId);
-	Pin* inPin = inNode->FindInputPin(inputPinId);
-	if (!outPin || !inPin) return false;
+	const PinRef& out = outIt->second;
+	const PinRef& in = inIt->second;
+	if (!out.isOutput || in.isOutput) return false;
+	if (out.node == in.node) return false; // No self-links
 
-	// Type check
-	if (outPin->dataType != inPin->dataType) return false;
+	// Type check (a heightfield may feed any mesh input; it is converted on the way)
+	bool heightfieldToMesh = out.pin->dataType == PinDataType::Heightfield && in.pin->dataType == PinDataType::Mesh;
+	if (out.pin->dataType != in.pin->dataType && !heightfieldToMesh) return false;
 
 	// Check if input already has a link (only one input per pin)
-	for (auto& link : links)
-		if (link.endPinId == inputPinId) return false;
+	if (inputLinks.count(inputPinId)) return false;
 
 	return true;
 }
@@ -122,121 +143,420 @@ bool NodeGraph::AddLink(int outputPinId, int inputPinId)
 
 	Link newLink(NextLinkId(), outputPinId, inputPinId);
 	links.push_back(newLink);
+	outgoingLinks[FindNodeByPinId(outputPinId)->id].push_back(newLink);
+	inputLinks[inputPinId] = newLink;
+	InvalidateLinkTarget(newLink);
 	return true;
 }
 
 void NodeGraph::RemoveLink(int linkId)
 {
-	links.erase(std::remove_if(links.begin(), links.end(),
-		[linkId](const Link& l) { return l.id == linkId; }), links.end());
+	auto it = std::find_if(links.begin(), links.end(), [linkId](const Link& l) { return l.id == linkId; });
+	if (it == links.end()) return;
+
+	Link link = *it;
+	links.erase(it);
+
+	InvalidateLinkTarget(link);
+	inputLinks.erase(link.endPinId);
+
+	GraphNode* srcNode = FindNodeByPinId(link.startPinId);
+	if (srcNode)
+	{
+		auto& outgoing = outgoingLinks[srcNode->id];
+		outgoing.erase(std::remove_if(outgoing.begin(), outgoing.end(),
+			[linkId](const Link& l) { return l.id == linkId; }), outgoing.end());
+	}
 }
 
 void NodeGraph::RemoveLinkByPinId(int pinId)
 {
-	links.erase(std::remove_if(links.begin(), links.end(),
-		[pinId](const Link& l) { return l.startPinId == pinId || l.endPinId == pinId; }), links.end());
+	std::vector<int> linkIds;
+	for (auto& link : links)
+		if (link.startPinId == pinId || link.endPinId == pinId) linkIds.push_back(link.id);
+
+	for (int linkId : linkIds)
+		RemoveLink(linkId);
 }
 
+void NodeGraph::InvalidateLinkTarget(const Link& link)
+{
+	auto it = pinIndex.find(link.endPinId);
+	if (it == pinIndex.end()) return;
 
+	it->second.pin->data.Clear();
+	it->second.node->MarkDirty();
+}
 
-std::vector<GraphNode*> NodeGraph::TopologicalSort()
+void NodeGraph::PropagateLink(const Link& link)
 {
-	// Build adjacency: node depends on which other nodes?
-	std::map<int, std::set<int>> dependencies; // nodeId -> set of nodeIds it depends on
-	std::map<int, int> inDegree;
+	Pin* srcPin = FindPinById(link.startPinId);
+	Pin* dstPin = FindPinById(link.endPinId);
+	if (srcPin && dstPin)
+	{
+		CopyPinData(*srcPin, *dstPin);
+	}
+}
 
-	for (auto* n : nodes)
+void NodeGraph::CopyPinData(const Pin& src, Pin& dst)
+{
+	if (dst.dataType == PinDataType::Mesh && src.data.type == PinDataType::Heightfield)
 	{
-		dependencies[n->id] = {};
-		inDegree[n->id] = 0;
+		dst.data.Clear();
+		dst.data.type = PinDataType::Mesh;
+		dst.data.meshData = src.data.GetHeightfieldMesh();
+		dst.data.sourceObjectName = src.data.sourceObjectName;
+		return;
 	}
+	dst.data = src.data;
+}
 
-	// For each link, the node owning the input pin depends on the node owning the output pin
-	for (auto& link : links)
+void NodeGraph::MarkAllDirty()
+{
+	for (auto* n : nodes)
+		n->MarkDirty();
+}
+
+NodeGraph::NodeAdjacency NodeGraph::BuildDependents()
+{
+	NodeAdjacency dependents;
+	for (auto& entry : outgoingLinks)
 	{
-		GraphNode* srcNode = FindNodeByPinId(link.startPinId);
-		GraphNode* dstNode = FindNodeByPinId(link.endPinId);
-		if (srcNode && dstNode && srcNode != dstNode)
+		GraphNode* srcNode = FindNode(entry.first);
+		if (!srcNode) continue;
+
+		auto& list = dependents[srcNode];
+		for (auto& link : entry.second)
 		{
-			if (dependencies[dstNode->id].insert(srcNode->id).second)
-			{
-				inDegree[dstNode->id]++;
-			}
+			GraphNode* dstNode = FindNodeByPinId(link.endPinId);
+			// Several links between the same pair of nodes count as one dependency
+			if (dstNode && dstNode != srcNode && std::find(list.begin(), list.end(), dstNode) == list.end())
+				list.push_back(dstNode);
 		}
 	}
+	return dependents;
+}
+
+std::vector<GraphNode*> NodeGraph::TopologicalSort()
+{
+	NodeAdjacency dependents = BuildDependents();
+
+	std::unordered_map<GraphNode*, int> inDegree;
+	for (auto* n : nodes) inDegree[n] = 0;
+	for (auto& entry : dependents)
+		for (auto* dst : entry.second) inDegree[dst]++;
 
 	// Kahn's algorithm
-	std::queue<int> ready;
+	std::queue<GraphNode*> ready;
 	for (auto* n : nodes)
 	{
-		if (inDegree[n->id] == 0)
-			ready.push(n->id);
+		if (inDegree[n] == 0)
+			ready.push(n);
 	}
 
 	std::vector<GraphNode*> sorted;
+	sorted.reserve(nodes.size());
 	while (!ready.empty())
 	{
-		int current = ready.front();
+		GraphNode* current = ready.front();
 		ready.pop();
-		sorted.push_back(FindNode(current));
+		sorted.push_back(current);
 
-		// For each node that depends on current, decrease in-degree
-		for (auto* n : nodes)
+		// Only the nodes that consume current's outputs lose an in-degree
+		auto it = dependents.find(current);
+		if (it == dependents.end()) continue;
+		for (auto* dst : it->second)
 		{
-			if (dependencies[n->id].count(current))
-			{
-				inDegree[n->id]--;
-				if (inDegree[n->id] == 0)
-					ready.push(n->id);
-			}
+			if (--inDegree[dst] == 0)
+				ready.push(dst);
 		}
 	}
 
 	return sorted;
 }
 
-void NodeGraph::Execute(SceneManager& scene, Texture* defaultTex, Material* defaultMat)
-{
-	if (nodes.empty()) return;
+// ========== Background Execution ==========
 
-	// Clear all pin data
-	for (auto* n : nodes)
+struct NodeGraph::GraphRun
+{
+	struct NodeStatus
+	{
+		std::atomic<int> state{ (int)NodeRunState::Queued };
+		std::atomic<float> progress{ 0.0f };
+	};
+
+	std::vector<GraphNode*> clones;                      // Snapshot copies, topological order
+	std::vector<unsigned int> revisions;                 // Live node revision at snapshot time (same order)
+	NodeAdjacency dependents;                            // Between clones only
+	std::unordered_map<int, std::vector<Link>> outgoing; // nodeId -> links leaving its outputs
+	std::unordered_map<int, Pin*> pins;                  // pinId -> clone pin
+	std::unordered_map<int, NodeStatus> status;          // nodeId -> state; never rehashed once running
+
+	std::atomic<bool> cancel{ false };
+	std::atomic<bool> finished{ false };
+	std::atomic<int> completed{ 0 };
+	std::thread thread;
+
+	~GraphRun()
 	{
-		for (auto& p : n->inputs) p.data.Clear();
-		for (auto& p : n->outputs) p.data.Clear();
+		for (auto* n : clones)
+			delete n;
 	}
 
-	// Execute in topological order
-	auto sorted = TopologicalSort();
+	void Run();
+};
 
-	for (auto* node : sorted)
+void NodeGraph::GraphRun::Run()
+{
+	// Dependency counts among the snapshot. Clean upstream nodes already filled the inputs
+	// before cloning, and nodes caught in a cycle are never part of the run.
+	std::unordered_map<GraphNode*, int> pendingInputs;
+	for (auto* n : clones) pendingInputs[n] = 0;
+	for (auto& entry : dependents)
+		for (auto* dst : entry.second) pendingInputs[dst]++;
+
+	std::mutex stateMutex;
+	std::condition_variable allDone;
+	int remaining = (int)clones.size();
+	ThreadPool& pool = ThreadPool::Get();
+
+	std::function<void(GraphNode*)> runNode = [&](GraphNode* node)
 	{
-		// Execute the node
-		node->Execute(scene);
+		NodeStatus& st = status.at(node->id);
 
-		// Propagate data from this node's outputs to connected inputs
-		for (auto& link : links)
+		// Once cancelled, the remaining nodes are skipped but still released so the run drains
+		if (!cancel.load())
 		{
-			Pin* srcPin = node->FindOutputPin(link.startPinId);
-			if (srcPin)
+			st.state.store((int)NodeRunState::Running);
+			node->Execute();
+		}
+
+		if (cancel.load())
+		{
+			st.state.store((int)NodeRunState::Cancelled);
+		}
+		else
+		{
+			// Each input pin has at most one link and its node is not ready yet, so no locking is needed
+			auto outIt = outgoing.find(node->id);
+			if (outIt != outgoing.end())
 			{
-				GraphNode* dstNode = FindNodeByPinId(link.endPinId);
-				if (dstNode)
+				for (auto& link : outIt->second)
 				{
-					Pin* dstPin = dstNode->FindInputPin(link.endPinId);
-					if (dstPin)
-					{
-						dstPin->data = srcPin->data;
-					}
+					auto src = pins.find(link.startPinId);
+					auto dst = pins.find(link.endPinId);
+					if (src != pins.end() && dst != pins.end())
+						CopyPinData(*src->second, *dst->second);
 				}
 			}
+			st.progress.store(1.0f);
+			st.state.store((int)NodeRunState::Done);
+			completed.fetch_add(1);
+		}
+
+		// Release dependents whose inputs are now all filled
+		std::lock_guard<std::mutex> lock(stateMutex);
+		auto depIt = dependents.find(node);
+		if (depIt != dependents.end())
+		{
+			for (auto* dst : depIt->second)
+			{
+				if (--pendingInputs[dst] == 0)
+					pool.Submit([&runNode, dst] { runNode(dst); });
+			}
+		}
+		if (--remaining == 0)
+			allDone.notify_all();
+	};
+
+	{
+		std::unique_lock<std::mutex> lock(stateMutex);
+		for (auto* n : clones)
+		{
+			if (pendingInputs[n] == 0)
+				pool.Submit([&runNode, n] { runNode(n); });
 		}
+
+		// runNode and the counters live on this stack frame, so wait for every node
+		allDone.wait(lock, [&remaining] { return remaining == 0; });
 	}
 
-	// After execution, process nodes that modify the scene
-	auto& objects = scene.GetObjects();
+	finished.store(true);
+}
+
+bool NodeGraph::ExecuteAsync(SceneManager& scene)
+{
+	if (activeRun || nodes.empty()) return false;
 
+	for (auto* n : nodes)
+		n->CheckSceneChanges(scene);
+
+	auto sorted = TopologicalSort();
+	auto dependents = BuildDependents();
+
+	// Carry dirtiness downstream (sorted order visits producers before consumers)
+	for (auto* node : sorted)
+	{
+		if (!node->dirty) continue;
+		auto it = dependents.find(node);
+		if (it == dependents.end()) continue;
+		for (auto* dst : it->second)
+			dst->MarkDirty();
+	}
+
+	std::vector<GraphNode*> toRun;
 	for (auto* node : sorted)
+		if (node->dirty) toRun.push_back(node);
+	if (toRun.empty()) return false;
+
+	// Reset pins of the nodes that re-run, then refill their inputs from clean (cached) producers
+	for (auto* node : toRun)
+	{
+		for (auto& p : node->inputs) p.data.Clear();
+		for (auto& p : node->outputs) p.data.Clear();
+	}
+	for (auto* node : sorted)
+	{
+		if (node->dirty) continue;
+		auto it = outgoingLinks.find(node->id);
+		if (it == outgoingLinks.end()) continue;
+		for (auto& link : it->second)
+			PropagateLink(link);
+	}
+
+	for (auto* node : toRun)
+		node->PrepareExecute(scene);
+
+	// Snapshot: the background thread only ever sees these copies, so the editor stays free to
+	// change parameters, links or even delete nodes while the run is in flight
+	auto run = std::make_unique<GraphRun>();
+	std::unordered_map<GraphNode*, GraphNode*> cloneOf;
+	for (auto* node : toRun)
+	{
+		GraphNode* clone = node->Clone();
+		GraphRun::NodeStatus& st = run->status[clone->id];
+		clone->cancelFlag = &run->cancel;
+		clone->progressSlot = &st.progress;
+
+		for (auto& p : clone->inputs) run->pins[p.id] = &p;
+		for (auto& p : clone->outputs) run->pins[p.id] = &p;
+
+		auto outIt = outgoingLinks.find(node->id);
+		if (outIt != outgoingLinks.end())
+			run->outgoing[node->id] = outIt->second;
+
+		run->clones.push_back(clone);
+		run->revisions.push_back(node->revision);
+		cloneOf[node] = clone;
+	}
+	for (auto* node : toRun)
+	{
+		auto it = dependents.find(node);
+		if (it == dependents.end()) continue;
+		auto& list = run->dependents[cloneOf[node]];
+		for (auto* dst : it->second)
+		{
+			auto c = cloneOf.find(dst);
+			if (c != cloneOf.end()) list.push_back(c->second);
+		}
+	}
+
+	run->thread = std::thread(&GraphRun::Run, run.get());
+	activeRun = std::move(run);
+	return true;
+}
+
+void NodeGraph::CancelExecution()
+{
+	if (activeRun)
+		activeRun->cancel.store(true);
+}
+
+void NodeGraph::WaitForRun()
+{
+	if (activeRun && activeRun->thread.joinable())
+		activeRun->thread.join();
+}
+
+float NodeGraph::GetProgress() const
+{
+	if (!activeRun || activeRun->clones.empty()) return 0.0f;
+
+	// Whole nodes count fully, the running ones by their own reported fraction
+	float sum = 0.0f;
+	for (auto& entry : activeRun->status)
+	{
+		if (entry.second.state.load() == (int)NodeRunState::Running)
+			sum += entry.second.progress.load();
+	}
+	sum += (float)activeRun->completed.load();
+	return sum / (float)activeRun->clones.size();
+}
+
+NodeRunState NodeGraph::GetNodeState(int nodeId) const
+{
+	if (!activeRun) return NodeRunState::Idle;
+	auto it = activeRun->status.find(nodeId);
+	return it != activeRun->status.end() ? (NodeRunState)it->second.state.load() : NodeRunState::Idle;
+}
+
+float NodeGraph::GetNodeProgress(int nodeId) const
+{
+	if (!activeRun) return 0.0f;
+	auto it = activeRun->status.find(nodeId);
+	return it != activeRun->status.end() ? it->second.progress.load() : 0.0f;
+}
+
+void NodeGraph::Update(SceneManager& scene, Texture* defaultTex, Material* defaultMat)
+{
+	if (!activeRun || !activeRun->finished.load()) return;
+	WaitForRun();
+
+	// Adopt finished results, skipping nodes that were deleted or edited while the run was in flight
+	// (they stay dirty and re-run next time), and everything downstream of them, since those were
+	// computed from the stale output. Nodes finished before a cancel are kept.
+	// Clones are in topological order, so a rejection always precedes its dependents.
+	std::vector<GraphNode*> applied;
+	std::unordered_set<GraphNode*> rejected;
+	for (size_t i = 0; i < activeRun->clones.size(); i++)
+	{
+		GraphNode* clone = activeRun->clones[i];
+		GraphNode* live = FindNode(clone->id);
+		bool stale = rejected.count(clone) || !live || live->revision != activeRun->revisions[i] ||
+			activeRun->status.at(clone->id).state.load() != (int)NodeRunState::Done;
+		if (stale)
+		{
+			auto depIt = activeRun->dependents.find(clone);
+			if (depIt != activeRun->dependents.end())
+				rejected.insert(depIt->second.begin(), depIt->second.end());
+			continue;
+		}
+
+		for (size_t p = 0; p < live->inputs.size(); p++) live->inputs[p].data = clone->inputs[p].data;
+		for (size_t p = 0; p < live->outputs.size(); p++) live->outputs[p].data = clone->outputs[p].data;
+		live->dirty = false;
+		applied.push_back(live);
+	}
+
+	bool cancelled = activeRun->cancel.load();
+	activeRun.reset();
+
+	ApplySceneChanges(scene, applied, defaultTex, defaultMat);
+
+	// The run's transient buffers are back in the pool now; keep a warm working set for the next execute
+	BufferPool::Get().Trim(POOL_KEEP_BYTES);
+
+	if (cancelled)
+		printf("Graph execution cancelled (%d nodes kept).\n", (int)applied.size());
+}
+
+void NodeGraph::ApplySceneChanges(SceneManager& scene, const std::vector<GraphNode*>& applied,
+	Texture* defaultTex, Material* defaultMat)
+{
+	auto& objects = scene.GetObjects();
+
+	for (auto* node : applied)
+
 	{
 		// 1. Handle ScatterNode (Modular Spawning)
 		if (node->title == "Scatter")
@@ -244,16 +564,20 @@ void NodeGraph::Execute(SceneManager& scene, Texture* defaultTex, Material* defa
 			ScatterNode* scatterNode = static_cast<ScatterNode*>(node);
 			if (scatterNode->IsSpawnMode())
 			{
-				// 1. Cleanup old spawned objects owned by THIS ScatterNode
-				for (const auto& name : scatterNode->GetSpawnedNames())
-				{
-					scene.RemoveObject(name);
-				}
-				scatterNode->SetSpawnedNames({});
+				// 1. Cleanup old spawned objects owned by THIS ScatterNode (one pass), then the meshes they shared
+				if (scatterNode->GetSpawnHandle() == 0)
+					scatterNode->SetSpawnHandle(scene.CreateSpawnHandle());
+				scene.RemoveSpawned(scatterNode->GetSpawnHandle());
+				for (Mesh* mesh : scatterNode->GetSpawnedMeshes())
+					delete mesh;
+				scatterNode->SetSpawnedMeshes({});
 
 				Pin& instancesPin = node->outputs[1]; // "Instances Only"
-				auto& transforms = instancesPin.data.transforms;
-				auto& instanceMeshes = instancesPin.data.instanceMeshes;
+				const TransformList& transforms = instancesPin.data.transforms.Get();
+				const std::vector<CowPtr<MeshData>>& prototypes = instancesPin.data.prototypes;
+
+				// One GPU mesh per unique prototype, created on first use and shared by its instances
+				std::vector<Mesh*> prototypeMeshes(prototypes.size(), nullptr);
 
 				if (!transforms.empty())
 				{
@@ -274,11 +598,12 @@ void NodeGraph::Execute(SceneManager& scene, Texture* defaultTex, Material* defa
 						}
 					}
 
-					std::vector<std::string> newSpawned;
+					std::vector<GameObject*> newSpawned;
+					newSpawned.reserve(transforms.size());
+					std::string namePrefix = "Instance_" + std::to_string(node->id) + "_";
 					for (int i = 0; i < (int)transforms.size(); i++)
 					{
-						std::string name = "Instance_" + std::to_string(node->id) + "_" + std::to_string(i);
-						GameObject* obj = new GameObject(name);
+						GameObject* obj = new GameObject(namePrefix + std::to_string(i));
 
 						glm::mat4 worldModel = glm::mat4(1.0f);
 						worldModel = glm::translate(worldModel, transforms[i].position);
@@ -300,22 +625,30 @@ void NodeGraph::Execute(SceneManager& scene, Texture* defaultTex, Material* defa
 						worldModel = glm::rotate(worldModel, glm::radians(transforms[i].rotation.z), glm::vec3(0, 0, 1));
 						worldModel = glm::scale(worldModel, transforms[i].scale);
 
-						// Set world pose BEFORE parenting, so SetParent can calculate correct local offset
+						// World pose now; AddObjects converts it to a local offset under the parent for the whole batch
 						obj->GetTransform().SetFromMatrix(worldModel);
 						obj->SetInheritScale(false); // Important: Set this BEFORE parenting so local scale isn't crushed
-						obj->SetParent(targetParent);
 
-						if (i < (int)instanceMeshes.size() && !instanceMeshes[i].vertices.empty())
-							obj->SetMesh(instanceMeshes[i].ToMesh());
+						int proto = transforms[i].prototype;
+						if (proto >= 0 && proto < (int)prototypes.size() && !prototypes[proto]->IsEmpty())
+						{
+							if (!prototypeMeshes[proto])
+								prototypeMeshes[proto] = prototypes[proto]->ToMesh();
+							obj->SetMesh(prototypeMeshes[proto]);
+						}
 
 						if (defaultTex) obj->SetTexture(defaultTex);
 						if (defaultMat) obj->SetMaterial(defaultMat);
 
-						scene.AddObject(obj);
-						newSpawned.push_back(name);
+						newSpawned.push_back(obj);
 					}
-					scatterNode->SetSpawnedNames(newSpawned);
-					printf("Scatter spawned %d modular objects.\n", (int)newSpawned.size());
+					scene.AddObjects(newSpawned, targetParent, scatterNode->GetSpawnHandle());
+
+					std::vector<Mesh*> usedMeshes;
+					for (Mesh* mesh : prototypeMeshes)
+						if (mesh) usedMeshes.push_back(mesh);
+					scatterNode->SetSpawnedMeshes(usedMeshes);
+					printf("Scatter spawned %d modular objects sharing %d meshes.\n", (int)newSpawned.size(), (int)usedMeshes.size());
 				}
 			}
 		}
@@ -343,38 +676,41 @@ void NodeGraph::Execute(SceneManager& scene, Texture* defaultTex, Material* defa
 			
 			if (targetIdx >= 0 && targetIdx < (int)objects.size())
 			{
-				if (updateNode->ShouldUpdateMesh() && meshInput.data.type == PinDataType::Mesh && !meshInput.data.meshData.vertices.empty())
+				if (updateNode->ShouldUpdateMesh() && meshInput.data.type == PinDataType::Mesh && !meshInput.data.meshData->IsEmpty())
 				{
 						// Update the existing mesh
 						GameObject* target = objects[targetIdx];
 						if (target->GetMesh())
 						{
-							MeshData uploadData = meshInput.data.meshData;
+							// Shares the pin's buffer; only the un-bake below takes a private copy
+							CowPtr<MeshData> uploadData = meshInput.data.meshData;
 							bool restoredScale = false;
 
 							// If we have transform data, we can "un-bake" the mesh to restore hierarchy scale
-							if (!meshInput.data.transforms.empty())
+							if (!meshInput.data.transforms->empty())
 							{
-								glm::vec3 originalScale = meshInput.data.transforms[0].scale;
+								glm::vec3 originalScale = meshInput.data.transforms.Get()[0].scale;
 								if (glm::length(originalScale) > 0.001f)
 								{
-									for (size_t i = 0; i < uploadData.vertices.size(); i += 14)
-									{
-										uploadData.vertices[i] /= originalScale.x;
-										uploadData.vertices[i + 1] /= originalScale.y;
-										uploadData.vertices[i + 2] /= originalScale.z;
-									}
+									MeshData& unbaked = uploadData.Write();
+									for (glm::vec3& p : unbaked.positions)
+										p /= originalScale;
 									restoredScale = true;
 								}
 							}
 
-							// Reuse VAO/VBO/IBO by calling CreateMesh again
-							target->GetMesh()->CreateMesh(
-								uploadData.vertices.data(),
-								uploadData.indices.data(),
-								(unsigned int)uploadData.vertices.size(),
-								(unsigned int)uploadData.indices.size()
-							);
+							if (target->GetSpawnOwner() != 0)
+							{
+								// Spawned instances share their prototype's Mesh (and a respawn deletes it), so the
+								// target gets its own Mesh and leaves the spawn group as a regular scene object
+								target->SetMesh(uploadData->ToMesh());
+								target->SetSpawnOwner(0);
+							}
+							else
+							{
+								// Reuse the existing Mesh object (CreateMesh is called again on it)
+								uploadData->UploadTo(target->GetMesh());
+							}
 
 							// Only reset scale if we DIDN'T restore it (e.g. for primitives or new objects)
 							if (!restoredScale)
@@ -384,7 +720,7 @@ void NodeGraph::Execute(SceneManager& scene, Texture* defaultTex, Material* defa
 							else
 							{
 								// Ensure the target object actually has the correct scale in its transform
-								target->GetTransform().SetScale(meshInput.data.transforms[0].scale);
+								target->GetTransform().SetScale(meshInput.data.transforms.Get()[0].scale);
 							}
 
 							// PERSIST: Save the CPU-side data so it can be retrieved by SceneInputNode later
@@ -395,7 +731,7 @@ void NodeGraph::Execute(SceneManager& scene, Texture* defaultTex, Material* defa
 					else
 					{
 						// If object has no mesh, create one
-						Mesh* newMesh = meshInput.data.meshData.ToMesh();
+						Mesh* newMesh = meshInput.data.meshData->ToMesh();
 						target->SetMesh(newMesh);
 						target->SetCPUMeshData(meshInput.data.meshData);
 					}
@@ -410,9 +746,17 @@ void NodeGraph::Execute(SceneManager& scene, Texture* defaultTex, Material* defa
 
 void NodeGraph::Clear()
 {
+	CancelExecution();
+	WaitForRun();
+	activeRun.reset();
+
 	for (auto* n : nodes)
 		delete n;
 	nodes.clear();
 	links.clear();
+	nodeIndex.clear();
+	pinIndex.clear();
+	outgoingLinks.clear();
+	inputLinks.clear();
 	generatedObjectNames.clear();
 }
@@ -3,6 +3,9 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <atomic>
+#include <memory>
 #include <glm/glm.hpp>
 #include "MeshData.h"
 
@@ -34,6 +37,17 @@ struct Link
 	Link(int id, int start, int end) : id(id), startPinId(start), endPinId(end) {}
 };
 
+// ========== Execution State ==========
+// Per-node state of a background run, shown in the node editor
+enum class NodeRunState
+{
+	Idle,
+	Queued,
+	Running,
+	Done,
+	Cancelled
+};
+
 // ========== Base Node ==========
 class GraphNode
 {
@@ -45,14 +59,42 @@ public:
 	glm::vec2 editorPos = glm::vec2(0.0f); // Position in node editor
 	bool positionSet = false;
 
+	// Incremental execution: only dirty nodes (and everything downstream of them) re-run,
+	// clean nodes keep their cached output pin data between executions.
+	bool dirty = true;
+	// Bumped on every edit; results of a background run are only accepted if it did not change meanwhile
+	unsigned int revision = 0;
+	void MarkDirty() { dirty = true; revision++; }
+
+	// Set on the snapshot copies of a background run. Long Execute loops poll IsCancelled()
+	// and may publish a 0..1 fraction through ReportProgress().
+	const std::atomic<bool>* cancelFlag = nullptr;
+	std::atomic<float>* progressSlot = nullptr;
+	bool IsCancelled() const { return cancelFlag && cancelFlag->load(std::memory_order_relaxed); }
+	void ReportProgress(float fraction) { if (progressSlot) progressSlot->store(fraction, std::memory_order_relaxed); }
+
 	GraphNode() : id(0) {}
 	virtual ~GraphNode() = default;
 
 	// Render ImGui controls inside the node body
 	virtual void RenderContent(SceneManager* scene) = 0;
 
-	// Process: read input pin data, compute, write output pin data
-	virtual void Execute(SceneManager& scene) = 0;
+	// Process: read input pin data, compute, write output pin data.
+	// Runs on a worker thread against a Clone() of the node, possibly alongside nodes from other
+	// branches; only touch this node's pins and never the scene.
+	virtual void Execute() = 0;
+
+	// Snapshot copy (parameters and pins) handed to the background executor.
+	// Pin data is copy-on-write, so this does not duplicate mesh buffers.
+	virtual GraphNode* Clone() const = 0;
+
+	// Called on the UI thread before execution. Nodes that read from the scene mark themselves
+	// dirty here when their source changed outside the graph.
+	virtual void CheckSceneChanges(SceneManager& scene) {}
+
+	// Called on the UI thread for every node about to run, right before it is cloned.
+	// Nodes that need scene data capture it here for Execute to use.
+	virtual void PrepareExecute(SceneManager& scene) {}
 
 	// Find a pin by ID
 	Pin* FindPin(int pinId);
@@ -72,6 +114,7 @@ public:
 	void RemoveNode(int nodeId);
 	GraphNode* FindNode(int nodeId);
 	GraphNode* FindNodeByPinId(int pinId);
+	Pin* FindPinById(int pinId);
 
 	// Link management
 	bool AddLink(int outputPinId, int inputPinId);
@@ -79,8 +122,18 @@ public:
 	void RemoveLinkByPinId(int pinId);
 	bool CanLink(int outputPinId, int inputPinId);
 
-	// Execution
-	void Execute(SceneManager& scene, Texture* defaultTex, Material* defaultMat);
+	// Execution (re-runs dirty nodes only). ExecuteAsync snapshots the dirty nodes and runs them on a
+	// background thread; Update must be called every frame on the GL thread to apply finished results.
+	bool ExecuteAsync(SceneManager& scene);
+	void Update(SceneManager& scene, Texture* defaultTex, Material* defaultMat);
+	void CancelExecution();
+	void MarkAllDirty();
+
+	// Progress of the current run (idle graphs report Idle / 0)
+	bool IsExecuting() const { return activeRun != nullptr; }
+	float GetProgress() const;
+	NodeRunState GetNodeState(int nodeId) const;
+	float GetNodeProgress(int nodeId) const;
 
 	// Accessors
 	std::vector<GraphNode*>& GetNodes() { return nodes; }
@@ -98,11 +151,48 @@ private:
 	std::vector<Link> links;
 	int nextId;
 
+	// Pooled mesh buffers kept cached between executes (see BufferPool)
+	static const size_t POOL_KEEP_BYTES = (size_t)256 << 20;
+
+	// Lookup indices, kept in sync by AddNode/RemoveNode/AddLink/RemoveLink
+	struct PinRef
+	{
+		GraphNode* node = nullptr;
+		Pin* pin = nullptr;
+		bool isOutput = false;
+	};
+	std::unordered_map<int, GraphNode*> nodeIndex;         // nodeId -> node
+	std::unordered_map<int, PinRef> pinIndex;              // pinId -> owning node + pin
+	std::unordered_map<int, std::vector<Link>> outgoingLinks; // nodeId -> links leaving its outputs
+	std::unordered_map<int, Link> inputLinks;              // input pinId -> its (single) link
+
+	using NodeAdjacency = std::unordered_map<GraphNode*, std::vector<GraphNode*>>;
+
 	// Topological sort for execution order
 	std::vector<GraphNode*> TopologicalSort();
 
-	// Propagate data along links (copy output pin data to connected input pins)
-	void PropagateData();
+	// For each node, the distinct nodes consuming at least one of its outputs
+	NodeAdjacency BuildDependents();
+
+	// Snapshot of the nodes being executed in the background (defined in NodeGraph.cpp)
+	struct GraphRun;
+	std::unique_ptr<GraphRun> activeRun;
+
+	// Block until the background thread of the current run has exited
+	void WaitForRun();
+
+	// Scene-mutating phase (mesh uploads, spawned objects); GL thread only
+	void ApplySceneChanges(SceneManager& scene, const std::vector<GraphNode*>& applied,
+		Texture* defaultTex, Material* defaultMat);
+
+	// Copy an output pin's data along 'link' into the connected input pin
+	void PropagateLink(const Link& link);
+
+	// Copy a link's payload; a Heightfield arriving at a Mesh pin is expanded to a mesh here
+	static void CopyPinData(const Pin& src, Pin& dst);
+
+	// Mark the node owning the input end of 'link' dirty and drop its stale input data
+	void InvalidateLinkTarget(const Link& link);
 
 	// Track generated objects for cleanup
 	std::vector<std::string> generatedObjectNames;
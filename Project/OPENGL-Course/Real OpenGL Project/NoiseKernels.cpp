@@ -0,0 +1,358 @@
+#include "NoiseKernels.h"
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define NOISE_SIMD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC exposes every intrinsic unconditionally; GCC/Clang need the target enabled per function
+#if defined(NOISE_SIMD_X86) && !defined(_MSC_VER)
+#define NOISE_TARGET_AVX2 __attribute__((target("avx2")))
+#define NOISE_TARGET_SSE41 __attribute__((target("sse4.1")))
+#else
+#define NOISE_TARGET_AVX2
+#define NOISE_TARGET_SSE41
+#endif
+
+// ========== Scalar ==========
+// The SIMD paths below mirror these operations one-for-one (same order, no FMA), which is what
+// keeps their output bit-identical.
+
+static inline float Fade(float t)
+{
+	// 6t^5 - 15t^4 + 10t^3
+	return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+static inline float Lerp(float a, float b, float t)
+{
+	return a + t * (b - a);
+}
+
+static inline float Grad(int hash, float x, float y)
+{
+	// Use lower 2 bits to pick gradient direction
+	int h = hash & 3;
+	float u = h < 2 ? x : y;
+	float v = h < 2 ? y : x;
+	return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+}
+
+float NoiseKernels::PerlinNoise2D(const int* perm, float x, float y)
+{
+	float fx = std::floor(x);
+	float fy = std::floor(y);
+
+	// Grid cell coordinates
+	int xi = (int)fx & 255;
+	int yi = (int)fy & 255;
+
+	// Relative position within cell
+	float xf = x - fx;
+	float yf = y - fy;
+
+	// Fade curves
+	float u = Fade(xf);
+	float v = Fade(yf);
+
+	// Hash coordinates of the 4 corners
+	int aa = perm[perm[xi] + yi];
+	int ab = perm[perm[xi] + yi + 1];
+	int ba = perm[perm[xi + 1] + yi];
+	int bb = perm[perm[xi + 1] + yi + 1];
+
+	// Blend
+	float x1 = Lerp(Grad(aa, xf, yf), Grad(ba, xf - 1.0f, yf), u);
+	float x2 = Lerp(Grad(ab, xf, yf - 1.0f), Grad(bb, xf - 1.0f, yf - 1.0f), u);
+
+	return Lerp(x1, x2, v);
+}
+
+float NoiseKernels::FractalNoise(const int* perm, int octaves, float persistence, float x, float y)
+{
+	float total = 0.0f;
+	float amp = 1.0f;
+	float freq = 1.0f;
+	float maxVal = 0.0f;
+
+	for (int i = 0; i < octaves; i++)
+	{
+		total += PerlinNoise2D(perm, x * freq, y * freq) * amp;
+		maxVal += amp;
+		amp *= persistence;
+		freq *= 2.0f;
+	}
+
+	return total / maxVal; // Normalize to roughly [-1, 1]
+}
+
+static void FractalNoiseScalar(const int* perm, int octaves, float persistence,
+	const float* xs, const float* ys, float* out, int count)
+{
+	for (int i = 0; i < count; i++)
+		out[i] = NoiseKernels::FractalNoise(perm, octaves, persistence, xs[i], ys[i]);
+}
+
+#ifdef NOISE_SIMD_X86
+
+// ========== AVX2 (8 lanes) ==========
+
+NOISE_TARGET_AVX2 static inline __m256 Fade8(__m256 t)
+{
+	__m256 t3 = _mm256_mul_ps(_mm256_mul_ps(t, t), t);
+	__m256 inner = _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f));
+	inner = _mm256_add_ps(_mm256_mul_ps(t, inner), _mm256_set1_ps(10.0f));
+	return _mm256_mul_ps(t3, inner);
+}
+
+NOISE_TARGET_AVX2 static inline __m256 Lerp8(__m256 a, __m256 b, __m256 t)
+{
+	return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+}
+
+NOISE_TARGET_AVX2 static inline __m256 Grad8(__m256i hash, __m256 x, __m256 y)
+{
+	__m256i h = _mm256_and_si256(hash, _mm256_set1_epi32(3));
+	__m256 low = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(2), h)); // h < 2
+	__m256 u = _mm256_blendv_ps(y, x, low);
+	__m256 v = _mm256_blendv_ps(x, y, low);
+
+	// Negation is a sign-bit flip, exactly like unary minus
+	__m256 sign = _mm256_set1_ps(-0.0f);
+	__m256 negU = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(h, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+	__m256 negV = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(h, _mm256_set1_epi32(2)), _mm256_set1_epi32(2)));
+	u = _mm256_xor_ps(u, _mm256_and_ps(negU, sign));
+	v = _mm256_xor_ps(v, _mm256_and_ps(negV, sign));
+	return _mm256_add_ps(u, v);
+}
+
+NOISE_TARGET_AVX2 static inline __m256 Perlin8(const int* perm, __m256 x, __m256 y)
+{
+	__m256 fx = _mm256_floor_ps(x);
+	__m256 fy = _mm256_floor_ps(y);
+
+	__m256i mask = _mm256_set1_epi32(255);
+	__m256i one = _mm256_set1_epi32(1);
+	__m256i xi = _mm256_and_si256(_mm256_cvttps_epi32(fx), mask);
+	__m256i yi = _mm256_and_si256(_mm256_cvttps_epi32(fy), mask);
+
+	__m256 xf = _mm256_sub_ps(x, fx);
+	__m256 yf = _mm256_sub_ps(y, fy);
+	__m256 u = Fade8(xf);
+	__m256 v = Fade8(yf);
+
+	__m256i px0 = _mm256_add_epi32(_mm256_i32gather_epi32(perm, xi, 4), yi);
+	__m256i px1 = _mm256_add_epi32(_mm256_i32gather_epi32(perm, _mm256_add_epi32(xi, one), 4), yi);
+	__m256i aa = _mm256_i32gather_epi32(perm, px0, 4);
+	__m256i ab = _mm256_i32gather_epi32(perm, _mm256_add_epi32(px0, one), 4);
+	__m256i ba = _mm256_i32gather_epi32(perm, px1, 4);
+	__m256i bb = _mm256_i32gather_epi32(perm, _mm256_add_epi32(px1, one), 4);
+
+	__m256 oneF = _mm256_set1_ps(1.0f);
+	__m256 xf1 = _mm256_sub_ps(xf, oneF);
+	__m256 yf1 = _mm256_sub_ps(yf, oneF);
+
+	__m256 x1 = Lerp8(Grad8(aa, xf, yf), Grad8(ba, xf1, yf), u);
+	__m256 x2 = Lerp8(Grad8(ab, xf, yf1), Grad8(bb, xf1, yf1), u);
+	return Lerp8(x1, x2, v);
+}
+
+NOISE_TARGET_AVX2 static void FractalNoiseAVX2(const int* perm, int octaves, float persistence,
+	const float* xs, const float* ys, float* out, int count)
+{
+	int i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 x = _mm256_loadu_ps(xs + i);
+		__m256 y = _mm256_loadu_ps(ys + i);
+		__m256 total = _mm256_setzero_ps();
+		float amp = 1.0f;
+		float freq = 1.0f;
+		float maxVal = 0.0f;
+
+		for (int o = 0; o < octaves; o++)
+		{
+			__m256 f = _mm256_set1_ps(freq);
+			__m256 n = Perlin8(perm, _mm256_mul_ps(x, f), _mm256_mul_ps(y, f));
+			total = _mm256_add_ps(total, _mm256_mul_ps(n, _mm256_set1_ps(amp)));
+			maxVal += amp;
+			amp *= persistence;
+			freq *= 2.0f;
+		}
+
+		_mm256_storeu_ps(out + i, _mm256_div_ps(total, _mm256_set1_ps(maxVal)));
+	}
+
+	FractalNoiseScalar(perm, octaves, persistence, xs + i, ys + i, out + i, count - i);
+}
+
+// ========== SSE4.1 (4 lanes) ==========
+
+NOISE_TARGET_SSE41 static inline __m128 Fade4(__m128 t)
+{
+	__m128 t3 = _mm_mul_ps(_mm_mul_ps(t, t), t);
+	__m128 inner = _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f));
+	inner = _mm_add_ps(_mm_mul_ps(t, inner), _mm_set1_ps(10.0f));
+	return _mm_mul_ps(t3, inner);
+}
+
+NOISE_TARGET_SSE41 static inline __m128 Lerp4(__m128 a, __m128 b, __m128 t)
+{
+	return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+}
+
+NOISE_TARGET_SSE41 static inline __m128 Grad4(__m128i hash, __m128 x, __m128 y)
+{
+	__m128i h = _mm_and_si128(hash, _mm_set1_epi32(3));
+	__m128 low = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(2)));
+	__m128 u = _mm_blendv_ps(y, x, low);
+	__m128 v = _mm_blendv_ps(x, y, low);
+
+	__m128 sign = _mm_set1_ps(-0.0f);
+	__m128 negU = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(h, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+	__m128 negV = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(h, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+	u = _mm_xor_ps(u, _mm_and_ps(negU, sign));
+	v = _mm_xor_ps(v, _mm_and_ps(negV, sign));
+	return _mm_add_ps(u, v);
+}
+
+// SSE has no gather, so table lookups go through memory
+NOISE_TARGET_SSE41 static inline __m128i Gather4(const int* table, __m128i idx)
+{
+	alignas(16) int i[4];
+	_mm_store_si128((__m128i*)i, idx);
+	return _mm_setr_epi32(table[i[0]], table[i[1]], table[i[2]], table[i[3]]);
+}
+
+NOISE_TARGET_SSE41 static inline __m128 Perlin4(const int* perm, __m128 x, __m128 y)
+{
+	__m128 fx = _mm_floor_ps(x);
+	__m128 fy = _mm_floor_ps(y);
+
+	__m128i mask = _mm_set1_epi32(255);
+	__m128i one = _mm_set1_epi32(1);
+	__m128i xi = _mm_and_si128(_mm_cvttps_epi32(fx), mask);
+	__m128i yi = _mm_and_si128(_mm_cvttps_epi32(fy), mask);
+
+	__m128 xf = _mm_sub_ps(x, fx);
+	__m128 yf = _mm_sub_ps(y, fy);
+	__m128 u = Fade4(xf);
+	__m128 v = Fade4(yf);
+
+	__m128i px0 = _mm_add_epi32(Gather4(perm, xi), yi);
+	__m128i px1 = _mm_add_epi32(Gather4(perm, _mm_add_epi32(xi, one)), yi);
+	__m128i aa = Gather4(perm, px0);
+	__m128i ab = Gather4(perm, _mm_add_epi32(px0, one));
+	__m128i ba = Gather4(perm, px1);
+	__m128i bb = Gather4(perm, _mm_add_epi32(px1, one));
+
+	__m128 oneF = _mm_set1_ps(1.0f);
+	__m128 xf1 = _mm_sub_ps(xf, oneF);
+	__m128 yf1 = _mm_sub_ps(yf, oneF);
+
+	__m128 x1 = Lerp4(Grad4(aa, xf, yf), Grad4(ba, xf1, yf), u);
+	__m128 x2 = Lerp4(Grad4(ab, xf, yf1), Grad4(bb, xf1, yf1), u);
+	return Lerp4(x1, x2, v);
+}
+
+NOISE_TARGET_SSE41 static void FractalNoiseSSE41(const int* perm, int octaves, float persistence,
+	const float* xs, const float* ys, float* out, int count)
+{
+	int i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(xs + i);
+		__m128 y = _mm_loadu_ps(ys + i);
+		__m128 total = _mm_setzero_ps();
+		float amp = 1.0f;
+		float freq = 1.0f;
+		float maxVal = 0.0f;
+
+		for (int o = 0; o < octaves; o++)
+		{
+			__m128 f = _mm_set1_ps(freq);
+			__m128 n = Perlin4(perm, _mm_mul_ps(x, f), _mm_mul_ps(y, f));
+			total = _mm_add_ps(total, _mm_mul_ps(n, _mm_set1_ps(amp)));
+			maxVal += amp;
+			amp *= persistence;
+			freq *= 2.0f;
+		}
+
+		_mm_storeu_ps(out + i, _mm_div_ps(total, _mm_set1_ps(maxVal)));
+	}
+
+	FractalNoiseScalar(perm, octaves, persistence, xs + i, ys + i, out + i, count - i);
+}
+
+// ========== Runtime dispatch ==========
+
+enum class SimdLevel { Scalar, SSE41, AVX2 };
+
+static SimdLevel DetectSimdLevel()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	bool sse41 = (info[2] & (1 << 19)) != 0;
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx = (info[2] & (1 << 28)) != 0;
+
+	bool avx2 = false;
+	if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6) // OS saves YMM registers
+	{
+		__cpuidex(info, 7, 0);
+		avx2 = (info[1] & (1 << 5)) != 0;
+	}
+
+	if (avx2) return SimdLevel::AVX2;
+	if (sse41) return SimdLevel::SSE41;
+	return SimdLevel::Scalar;
+#else
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+	if (__builtin_cpu_supports("sse4.1")) return SimdLevel::SSE41;
+	return SimdLevel::Scalar;
+#endif
+}
+
+static SimdLevel GetSimdLevel()
+{
+	static const SimdLevel level = DetectSimdLevel();
+	return level;
+}
+
+#endif // NOISE_SIMD_X86
+
+void NoiseKernels::FractalNoiseBatch(const int* perm, int octaves, float persistence,
+	const float* xs, const float* ys, float* out, int count)
+{
+#ifdef NOISE_SIMD_X86
+	switch (GetSimdLevel())
+	{
+	case SimdLevel::AVX2: FractalNoiseAVX2(perm, octaves, persistence, xs, ys, out, count); return;
+	case SimdLevel::SSE41: FractalNoiseSSE41(perm, octaves, persistence, xs, ys, out, count); return;
+	default: break;
+	}
+#endif
+	FractalNoiseScalar(perm, octaves, persistence, xs, ys, out, count);
+}
+
+const char* NoiseKernels::GetSimdName()
+{
+#ifdef NOISE_SIMD_X86
+	switch (GetSimdLevel())
+	{
+	case SimdLevel::AVX2: return "AVX2";
+	case SimdLevel::SSE41: return "SSE4.1";
+	default: break;
+	}
+#endif
+	return "Scalar";
+}
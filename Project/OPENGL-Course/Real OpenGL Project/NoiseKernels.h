@@ -0,0 +1,19 @@
+#pragma once
+
+// Perlin / fBm evaluation shared by the noise generators.
+// The batch entry point evaluates 8 (AVX2) or 4 (SSE4.1) samples per instruction, picked at
+// runtime from the CPU, and produces exactly the same floats as the scalar path.
+class NoiseKernels
+{
+public:
+	// 'perm' is a 512-entry permutation table (256 entries duplicated)
+	static float PerlinNoise2D(const int* perm, float x, float y);
+	static float FractalNoise(const int* perm, int octaves, float persistence, float x, float y);
+
+	// out[i] = FractalNoise(xs[i], ys[i]) for i in [0, count)
+	static void FractalNoiseBatch(const int* perm, int octaves, float persistence,
+		const float* xs, const float* ys, float* out, int count);
+
+	// Name of the instruction set used by FractalNoiseBatch ("AVX2", "SSE4.1" or "Scalar")
+	static const char* GetSimdName();
+};
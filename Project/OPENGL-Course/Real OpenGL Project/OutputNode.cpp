@@ -20,9 +20,10 @@ void OutputNode::RenderContent(SceneManager* scene)
 	if (!scene) return;
 	auto& objects = scene->GetObjects();
 
-	ImGui::Checkbox("Same As Input", &sameAsInput);
+	bool changed = false;
+	changed |= ImGui::Checkbox("Same As Input", &sameAsInput);
 	ImGui::SameLine();
-	ImGui::Checkbox("Update Target Mesh", &updateMesh);
+	changed |= ImGui::Checkbox("Update Target Mesh", &updateMesh);
 
 	if (!sameAsInput)
 	{
@@ -64,6 +65,7 @@ void OutputNode::RenderContent(SceneManager* scene)
 			{
 				targetIndex = i;
 				targetName = objects[i]->GetName();
+				changed = true;
 			}
 		}
 		ImGui::EndCombo();
@@ -72,9 +74,11 @@ void OutputNode::RenderContent(SceneManager* scene)
 	if (targetIndex >= 0 && targetIndex < (int)objects.size())
 		ImGui::TextColored(ImVec4(0, 1, 0, 1), "Target: %s", objects[targetIndex]->GetName().c_str());
 	}
+
+	if (changed) MarkDirty();
 }
 
-void OutputNode::Execute(SceneManager& scene)
+void OutputNode::Execute()
 {
-	// Logic is handled in NodeGraph::Execute because it needs access to SceneManager
+	// Logic is handled in NodeGraph::ApplySceneChanges, which runs on the GL thread with access to SceneManager
 }
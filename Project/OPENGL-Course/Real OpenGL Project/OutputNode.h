@@ -15,7 +15,8 @@ public:
 	OutputNode(NodeGraph& graph);
 
 	void RenderContent(SceneManager* scene) override;
-	void Execute(SceneManager& scene) override;
+	void Execute() override;
+	GraphNode* Clone() const override { return new OutputNode(*this); }
 
 	// Helper for the graph execution to find where to push the mesh
 	int GetTargetIndex() const { return targetIndex; }
@@ -1,6 +1,7 @@
 #include "PerlinNoiseGenerator.h"
+#include "NoiseKernels.h"
+#include "ThreadPool.h"
 #include "imgui.h"
-#include <cstdlib>
 #include <algorithm>
 
 PerlinNoiseGenerator::PerlinNoiseGenerator()
@@ -14,14 +15,15 @@ PerlinNoiseGenerator::PerlinNoiseGenerator()
 void PerlinNoiseGenerator::InitPermutation()
 {
 	// Standard Perlin permutation table seeded with our seed
-	std::srand(seed);
+	rng.seed((unsigned int)seed);
+	permutationSeed = seed;
 	for (int i = 0; i < 256; i++)
 		permutation[i] = i;
 
-	// Fisher-Yates shuffle
+	// Fisher-Yates shuffle (raw engine output, so the table is identical on every platform)
 	for (int i = 255; i > 0; i--)
 	{
-		int j = std::rand() % (i + 1);
+		int j = (int)(rng() % (unsigned int)(i + 1));
 		std::swap(permutation[i], permutation[j]);
 	}
 	// Duplicate for overflow
@@ -29,87 +31,26 @@ void PerlinNoiseGenerator::InitPermutation()
 		permutation[256 + i] = permutation[i];
 }
 
-float PerlinNoiseGenerator::Fade(float t)
+void PerlinNoiseGenerator::SampleNoise(const float* xs, const float* zs, float* out, int count) const
 {
-	// 6t^5 - 15t^4 + 10t^3
-	return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+	NoiseKernels::FractalNoiseBatch(permutation, octaves, persistence, xs, zs, out, count);
 }
 
-float PerlinNoiseGenerator::Lerp(float a, float b, float t)
-{
-	return a + t * (b - a);
-}
-
-float PerlinNoiseGenerator::Grad(int hash, float x, float y)
-{
-	// Use lower 2 bits to pick gradient direction
-	int h = hash & 3;
-	float u = h < 2 ? x : y;
-	float v = h < 2 ? y : x;
-	return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
-}
-
-float PerlinNoiseGenerator::PerlinNoise2D(float x, float y)
-{
-	// Grid cell coordinates
-	int xi = (int)floor(x) & 255;
-	int yi = (int)floor(y) & 255;
-
-	// Relative position within cell
-	float xf = x - floor(x);
-	float yf = y - floor(y);
-
-	// Fade curves
-	float u = Fade(xf);
-	float v = Fade(yf);
-
-	// Hash coordinates of the 4 corners
-	int aa = permutation[permutation[xi] + yi];
-	int ab = permutation[permutation[xi] + yi + 1];
-	int ba = permutation[permutation[xi + 1] + yi];
-	int bb = permutation[permutation[xi + 1] + yi + 1];
-
-	// Blend
-	float x1 = Lerp(Grad(aa, xf, yf), Grad(ba, xf - 1.0f, yf), u);
-	float x2 = Lerp(Grad(ab, xf, yf - 1.0f), Grad(bb, xf - 1.0f, yf - 1.0f), u);
-
-	return Lerp(x1, x2, v);
-}
-
-float PerlinNoiseGenerator::FractalNoise(float x, float y)
-{
-	float total = 0.0f;
-	float amp = 1.0f;
-	float freq = 1.0f;
-	float maxVal = 0.0f;
-
-	for (int i = 0; i < octaves; i++)
-	{
-		total += PerlinNoise2D(x * freq, y * freq) * amp;
-		maxVal += amp;
-		amp *= persistence;
-		freq *= 2.0f;
-	}
-
-	return total / maxVal; // Normalize to roughly [-1, 1]
-}
-
-
-
-void PerlinNoiseGenerator::RenderUI()
+bool PerlinNoiseGenerator::RenderUI()
 {
 	ImGui::PushID(this);
 
 	bool seedChanged = false;
+	bool changed = false;
 
 	ImGui::Text("Noise Settings");
-	ImGui::DragFloat("Amplitude", &amplitude, 0.05f, 0.0f, 100.0f);
-	ImGui::DragFloat("Frequency", &frequency, 0.001f, 0.001f, 1.0f);
+	changed |= ImGui::DragFloat("Amplitude", &amplitude, 0.05f, 0.0f, 100.0f);
+	changed |= ImGui::DragFloat("Frequency", &frequency, 0.001f, 0.001f, 1.0f);
 	
-	ImGui::DragFloat2("Offset", &offsetX, 0.1f);
+	changed |= ImGui::DragFloat2("Offset", &offsetX, 0.1f);
 
-	ImGui::SliderInt("Octaves", &octaves, 1, 10);
-	ImGui::DragFloat("Persistence", &persistence, 0.01f, 0.01f, 1.0f);
+	changed |= ImGui::SliderInt("Octaves", &octaves, 1, 10);
+	changed |= ImGui::DragFloat("Persistence", &persistence, 0.01f, 0.01f, 1.0f);
 
 	ImGui::Separator();
 	if (ImGui::InputInt("Seed", &seed))
@@ -117,7 +58,7 @@ void PerlinNoiseGenerator::RenderUI()
 	ImGui::SameLine();
 	if (ImGui::Button("Randomize"))
 	{
-		seed = std::rand();
+		seed = (int)(std::random_device{}() & 0x7fffffff);
 		seedChanged = true;
 	}
 
@@ -125,89 +66,162 @@ void PerlinNoiseGenerator::RenderUI()
 		InitPermutation();
 
 	ImGui::PopID();
+	return changed || seedChanged;
 }
 
-MeshData PerlinNoiseGenerator::Generate(const MeshData* input)
+HeightfieldData PerlinNoiseGenerator::GenerateHeightfield(int resolution, float worldSize)
 {
-	// Re-init permutation table (seed may have changed)
-	InitPermutation();
+	if (permutationSeed != seed)
+		InitPermutation();
+
+	HeightfieldData field;
+	int samples = std::max(resolution, 1) + 1;
+	float halfSize = worldSize * 0.5f;
+	field.Resize(samples, samples, glm::vec2(-halfSize), glm::vec2(worldSize));
+	SampleHeightfield(field);
+	return field;
+}
 
-	MeshData data;
-	if (!input || input->vertices.empty())
+void PerlinNoiseGenerator::SampleHeightfield(HeightfieldData& field) const
+{
+	int samplesX = field.samplesX;
+	float spacingX = field.GetSpacingX();
+	float spacingZ = field.GetSpacingZ();
+
+	// One row of samples per batch call; rows are independent
+	ThreadPool::Get().ParallelFor(0, field.samplesZ, 16, [&](int begin, int end)
 	{
-		// Fallback: Generate a simple subdivided plane if no input
-		// (Reuse old logic but simplified)
-		int verticesPerSide = 51; // 50x50 grid
-		float fallbackScale = 0.2f;
-		float halfSize = (50 * fallbackScale) / 2.0f;
-
-		for (int z = 0; z < verticesPerSide; z++) {
-			for (int x = 0; x < verticesPerSide; x++) {
-				float worldX = (float)x * fallbackScale - halfSize;
-				float worldZ = (float)z * fallbackScale - halfSize;
-				// Add small shifts (0.123) to avoid exact-integer-sampling zero pits
-				float noise = FractalNoise((worldX + offsetX + 0.123f) * frequency, (worldZ + offsetZ + 0.123f) * frequency) * amplitude;
-				data.AddVertex(worldX, noise, worldZ, (float)x/50.0f, (float)z/50.0f, 0,1,0, 1,0,0, 0,0,1);
-			}
-		}
-		for (int z = 0; z < 50; z++) {
-			for (int x = 0; x < 50; x++) {
-				unsigned int topLeft = z * verticesPerSide + x;
-				unsigned int topRight = topLeft + 1;
-				unsigned int bottomLeft = (z + 1) * verticesPerSide + x;
-				unsigned int bottomRight = bottomLeft + 1;
-				data.AddTriangle(topLeft, bottomLeft, topRight);
-				data.AddTriangle(topRight, bottomLeft, bottomRight);
+		std::vector<float> xs(samplesX), zs(samplesX);
+		for (int z = begin; z < end; z++)
+		{
+			float worldZ = field.origin.y + (float)z * spacingZ;
+			for (int x = 0; x < samplesX; x++)
+			{
+				xs[x] = field.origin.x + (float)x * spacingX;
+				zs[x] = worldZ;
 			}
+			SampleHeights(xs.data(), zs.data(), &field.At(0, z), samplesX);
 		}
-	}
-	else
+	});
+}
+
+void PerlinNoiseGenerator::SampleHeights(const float* worldXs, const float* worldZs, float* out, int count) const
+{
+	const int BLOCK = 256;
+	float xs[BLOCK], zs[BLOCK];
+	for (int start = 0; start < count; start += BLOCK)
 	{
-		// Displace existing input mesh
-		data = *input;
-		int vertCount = data.GetVertexCount();
-		for (int i = 0; i < vertCount; i++)
+		int n = std::min(BLOCK, count - start);
+		for (int k = 0; k < n; k++)
 		{
-			int base = i * 14;
-			float x = data.vertices[base];
-			float z = data.vertices[base + 2];
-
-			// Apply noise to Y (index base + 1)
-			// Apply sampling with offset and small shift to avoid integer-coordinate zero-return
-			float noise = FractalNoise((x + offsetX + 0.1234f) * frequency, (z + offsetZ + 0.1234f) * frequency);
-			data.vertices[base + 1] += noise * amplitude;
+			// Add small shifts (0.123) to avoid exact-integer-sampling zero pits
+			xs[k] = (worldXs[start + k] + offsetX + 0.123f) * frequency;
+			zs[k] = (worldZs[start + k] + offsetZ + 0.123f) * frequency;
 		}
+		SampleNoise(xs, zs, out + start, n);
+		for (int k = 0; k < n; k++)
+			out[start + k] *= amplitude;
 	}
+}
 
-	// Recalculate normals etc.
+MeshData PerlinNoiseGenerator::Generate(const MeshData* input)
+{
+	// The table only depends on the seed; RenderUI rebuilds it on change, this catches programmatic edits
+	if (permutationSeed != seed)
+		InitPermutation();
+
+	// Fallback: a 50x50 grid (0.2 spacing) generated as a heightfield, whose normals already come from it
+	if (!input || input->IsEmpty())
+		return GenerateHeightfield(50, 10.0f).ToMeshData();
+
+	// Displace existing input mesh
+	MeshData data = *input;
 	int vertCount = data.GetVertexCount();
-	if (vertCount == 0) return data;
 
-	std::vector<float> nx(vertCount, 0.0f), ny(vertCount, 0.0f), nz(vertCount, 0.0f);
-	for (int i = 0; i < (int)data.indices.size(); i += 3)
+	// Vertices are independent, so ranges are displaced in parallel. Each range is sampled in
+	// fixed-size blocks so the batch kernel sees contiguous coordinate arrays.
+	ThreadPool::Get().ParallelFor(0, vertCount, 4096, [&](int begin, int end)
 	{
-		unsigned int i0 = data.indices[i];
-		unsigned int i1 = data.indices[i + 1];
-		unsigned int i2 = data.indices[i + 2];
-		float* v0 = &data.vertices[i0 * 14];
-		float* v1 = &data.vertices[i1 * 14];
-		float* v2 = &data.vertices[i2 * 14];
-		float e1x = v1[0] - v0[0], e1y = v1[1] - v0[1], e1z = v1[2] - v0[2];
-		float e2x = v2[0] - v0[0], e2y = v2[1] - v0[1], e2z = v2[2] - v0[2];
-		float cx = e1y * e2z - e1z * e2y, cy = e1z * e2x - e1x * e2z, cz = e1x * e2y - e1y * e2x;
-		nx[i0] += cx; ny[i0] += cy; nz[i0] += cz;
-		nx[i1] += cx; ny[i1] += cy; nz[i1] += cz;
-		nx[i2] += cx; ny[i2] += cy; nz[i2] += cz;
-	}
+		const int BLOCK = 256;
+		float xs[BLOCK], zs[BLOCK], noise[BLOCK];
+		for (int start = begin; start < end; start += BLOCK)
+		{
+			int n = std::min(BLOCK, end - start);
+			const glm::vec3* p = &data.positions[start];
+			for (int k = 0; k < n; k++)
+			{
+				// Apply sampling with offset and small shift to avoid integer-coordinate zero-return
+				xs[k] = (p[k].x + offsetX + 0.1234f) * frequency;
+				zs[k] = (p[k].z + offsetZ + 0.1234f) * frequency;
+			}
+			SampleNoise(xs, zs, noise, n);
 
-	for (int i = 0; i < vertCount; i++)
-	{
-		float len = sqrtf(nx[i] * nx[i] + ny[i] * ny[i] + nz[i] * nz[i]);
-		if (len > 0.0f) { nx[i] /= len; ny[i] /= len; nz[i] /= len; }
-		data.vertices[i * 14 + 5] = nx[i];
-		data.vertices[i * 14 + 6] = ny[i];
-		data.vertices[i * 14 + 7] = nz[i];
-	}
+			// Apply noise to Y
+			for (int k = 0; k < n; k++)
+				data.positions[start + k].y += noise[k] * amplitude;
+		}
+	});
 
+	// Recalculate normals etc.
+	RecalculateNormals(data);
 	return data;
 }
+
+void PerlinNoiseGenerator::RecalculateNormals(MeshData& data)
+{
+	int vertCount = data.GetVertexCount();
+	int triCount = (int)data.indices.size() / 3;
+	const unsigned int* idx = data.indices.data();
+	const glm::vec3* pos = data.positions.data();
+	glm::vec3* nrm = data.normals.data();
+	ThreadPool& pool = ThreadPool::Get();
+
+	// 1. Face normals (unnormalized cross product, so larger faces weigh more)
+	PooledVector<float> faceNormals((size_t)triCount * 3);
+	pool.ParallelFor(0, triCount, 4096, [&](int begin, int end)
+	{
+		for (int t = begin; t < end; t++)
+		{
+			const glm::vec3& v0 = pos[idx[t * 3]];
+			const glm::vec3& v1 = pos[idx[t * 3 + 1]];
+			const glm::vec3& v2 = pos[idx[t * 3 + 2]];
+			float e1x = v1.x - v0.x, e1y = v1.y - v0.y, e1z = v1.z - v0.z;
+			float e2x = v2.x - v0.x, e2y = v2.y - v0.y, e2z = v2.z - v0.z;
+			faceNormals[t * 3] = e1y * e2z - e1z * e2y;
+			faceNormals[t * 3 + 1] = e1z * e2x - e1x * e2z;
+			faceNormals[t * 3 + 2] = e1x * e2y - e1y * e2x;
+		}
+	});
+
+	// 2. Vertex -> triangle adjacency (CSR). Each vertex lists its triangles in ascending order,
+	// once per corner, so the gather below adds the same terms in the same order as a serial
+	// scatter-add would: results do not depend on the thread count.
+	PooledVector<int> offsets(vertCount + 1, 0);
+	for (int i = 0; i < triCount * 3; i++)
+		offsets[idx[i] + 1]++;
+	for (int v = 0; v < vertCount; v++)
+		offsets[v + 1] += offsets[v];
+
+	PooledVector<int> adjacency(triCount * 3);
+	PooledVector<int> cursor(offsets.begin(), offsets.end() - 1);
+	for (int i = 0; i < triCount * 3; i++)
+		adjacency[cursor[idx[i]]++] = i / 3;
+
+	// 3. Gather and normalize; every vertex is written by exactly one thread
+	pool.ParallelFor(0, vertCount, 4096, [&](int begin, int end)
+	{
+		for (int v = begin; v < end; v++)
+		{
+			float nx = 0.0f, ny = 0.0f, nz = 0.0f;
+			for (int k = offsets[v]; k < offsets[v + 1]; k++)
+			{
+				const float* fn = &faceNormals[adjacency[k] * 3];
+				nx += fn[0]; ny += fn[1]; nz += fn[2];
+			}
+
+			float len = sqrtf(nx * nx + ny * ny + nz * nz);
+			if (len > 0.0f) { nx /= len; ny /= len; nz /= len; }
+			nrm[v] = glm::vec3(nx, ny, nz);
+		}
+	});
+}
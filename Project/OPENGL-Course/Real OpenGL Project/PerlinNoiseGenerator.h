@@ -3,13 +3,14 @@
 #include "IGenerator.h"
 #include <vector>
 #include <cmath>
+#include <random>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
 // Perlin Noise terrain generator.
-// Generates a subdivided grid with noise-based Y displacement.
+// Displaces an input mesh in Y, or produces a heightfield / grid mesh from scratch.
 class PerlinNoiseGenerator : public IGenerator
 {
 public:
@@ -17,11 +18,21 @@ public:
 	~PerlinNoiseGenerator() override = default;
 
 	std::string GetName() const override { return "Perlin Noise"; }
-	void RenderUI() override;
+	bool RenderUI() override;
 	MeshData Generate(const MeshData* input) override;
 
 	void SetOffset(float x, float z) { offsetX = x; offsetZ = z; }
 
+	// Noise heights sampled on a (resolution + 1)^2 grid centred on the origin, 'worldSize' across
+	HeightfieldData GenerateHeightfield(int resolution, float worldSize);
+
+	// Fill 'field' (already sized and placed) with noise heights
+	void SampleHeightfield(HeightfieldData& field) const;
+
+	// out[i] = terrain height at world (xs[i], zs[i]). Read-only, so one generator can be sampled
+	// from several threads at once (e.g. terrain chunk jobs); the table must be current.
+	void SampleHeights(const float* worldXs, const float* worldZs, float* out, int count) const;
+
 private:
 	// Configurable parameters
 	int gridSize;         // Grid resolution (gridSize x gridSize quads)
@@ -34,13 +45,16 @@ private:
 	float offsetZ;        // Sampling offset Z
 	int seed;             // Random seed
 
-	// Internal Perlin noise implementation
+	// Internal Perlin noise implementation (evaluated by NoiseKernels).
+	// Each generator owns its RNG and table, rebuilt only when the seed changes.
+	std::mt19937 rng;
 	int permutation[512];
+	int permutationSeed;
 	void InitPermutation();
 
-	float Fade(float t);
-	float Lerp(float a, float b, float t);
-	float Grad(int hash, float x, float y);
-	float PerlinNoise2D(float x, float y);
-	float FractalNoise(float x, float y);
+	// out[i] = fBm at (xs[i], zs[i]) with the current octaves/persistence
+	void SampleNoise(const float* xs, const float* zs, float* out, int count) const;
+
+	// Smooth per-vertex normals from the (area-weighted) face normals, computed in parallel
+	static void RecalculateNormals(MeshData& data);
 };
@@ -24,10 +24,12 @@ public:
 
 	void RenderContent(SceneManager* scene) override
 	{
-		generator.RenderUI();
+		if (generator.RenderUI()) MarkDirty();
 	}
 
-	void Execute(SceneManager& scene) override
+	GraphNode* Clone() const override { return new PerlinNoiseNode(*this); }
+
+	void Execute() override
 	{
 		outputs[0].data.Clear();
 		outputs[0].data.type = PinDataType::Mesh;
@@ -35,48 +37,40 @@ public:
 
 		if (inputs[0].data.type != PinDataType::Mesh) return;
 
-		auto& inputTransforms = inputs[0].data.transforms;
-		auto& inputInstances = inputs[0].data.instanceMeshes;
+		const TransformList& inputTransforms = inputs[0].data.transforms.Get();
+		const std::vector<CowPtr<MeshData>>& inputPrototypes = inputs[0].data.prototypes;
 
-		if (!inputInstances.empty())
+		if (!inputPrototypes.empty())
 		{
-			// Process each instance individually
-			outputs[0].data.transforms = inputTransforms;
-			outputs[0].data.instanceMeshes.reserve(inputInstances.size());
-			
-			// We also need to rebuild the baked "meshData" for the output
-			// If the input has a base mesh (like the Plane), keep it as the start,
-			// but we skip it if it's strictly a scatter output. 
-			// For simplicity: we'll follow the ScatterNode pattern and merge all instances into outputs[0].data.meshData.
-			MeshData merged;
-
-			for (size_t i = 0; i < inputInstances.size(); i++)
+			// Process each instance individually. The noise is offset by the instance position,
+			// so every displaced instance becomes a prototype of its own.
+			TransformList& outputTransforms = outputs[0].data.transforms.Write();
+			outputTransforms = inputTransforms;
+			outputs[0].data.prototypes.reserve(inputTransforms.size());
+
+			for (size_t i = 0; i < inputTransforms.size(); i++)
 			{
-				const MeshData& instance = inputInstances[i];
-				
+				if (IsCancelled()) return;
+				ReportProgress((float)i / (float)inputTransforms.size());
+
+				int src = inputTransforms[i].prototype;
+				if (src < 0 || src >= (int)inputPrototypes.size()) src = 0;
+
 				// Apply noise with offset from transform position
-				if (i < inputTransforms.size())
-				{
-					generator.SetOffset(inputTransforms[i].position.x, inputTransforms[i].position.z);
-				}
-				
-				MeshData deformed = generator.Generate(&instance);
-				outputs[0].data.instanceMeshes.push_back(deformed);
-
-				// Merge into baked result "instanced style" (this part is tricky, MeshData::Append? No, we need transforms!)
-				// Actually, ScatterNode already merged them. If we change them, we have to re-merge.
-				// This might be slow for 1000 objects, but it's the "correct" way.
-				
-				// Re-use logic for merging but we need a way to access MergeTransformed...
-				// Or we just rely on the user using the modular "Spawning" output.
-				// Let's at least provide a basic merged result if possible.
+				generator.SetOffset(inputTransforms[i].position.x, inputTransforms[i].position.z);
+
+				outputs[0].data.prototypes.push_back(generator.Generate(&inputPrototypes[src].Get()));
+				outputTransforms[i].prototype = (int)i;
+
+				// The baked "meshData" is not rebuilt here; use the modular "Spawning" output
+				// of the Scatter node to see displaced instances.
 			}
 		}
 		else
 		{
 			// Standard single-mesh mode
-			outputs[0].data.meshData = generator.Generate(&inputs[0].data.meshData);
-			outputs[0].data.transforms = inputs[0].data.transforms; // Propagate transform
+			outputs[0].data.meshData = generator.Generate(&inputs[0].data.meshData.Get());
+			outputs[0].data.transforms = inputs[0].data.transforms; // Propagate transform (shared, no copy)
 		}
 	}
 
@@ -2,9 +2,10 @@
 
 #include "NodeGraph.h"
 #include "PerlinNoiseGenerator.h"
+#include "imgui.h"
 
-// Generates terrain mesh using Perlin noise.
-// No inputs, one Mesh output.
+// Generates terrain heights using Perlin noise.
+// No inputs, one Heightfield output (linkable to any Mesh input, converted there).
 class PerlinTerrainNode : public GraphNode
 {
 public:
@@ -14,23 +15,34 @@ public:
 		title = "Perlin Terrain";
 
 		// No inputs
-		// One output: Mesh
-		Pin meshOut(graph.NextPinId(), PinDataType::Mesh, "Mesh");
-		outputs.push_back(meshOut);
+		// One output: Heightfield
+		Pin heightOut(graph.NextPinId(), PinDataType::Heightfield, "Heightfield");
+		outputs.push_back(heightOut);
 	}
 
 	void RenderContent(SceneManager* scene) override
 	{
-		generator.RenderUI();
+		ImGui::PushID(this);
+		bool changed = false;
+		changed |= ImGui::SliderInt("Resolution", &resolution, 8, 2048);
+		changed |= ImGui::DragFloat("Size", &worldSize, 0.5f, 1.0f, 10000.0f);
+		ImGui::PopID();
+
+		if (generator.RenderUI()) changed = true;
+		if (changed) MarkDirty();
 	}
 
-	void Execute(SceneManager& scene) override
+	GraphNode* Clone() const override { return new PerlinTerrainNode(*this); }
+
+	void Execute() override
 	{
-		MeshData data = generator.Generate(nullptr);
-		outputs[0].data.type = PinDataType::Mesh;
-		outputs[0].data.meshData = data;
+		outputs[0].data.Clear();
+		outputs[0].data.type = PinDataType::Heightfield;
+		outputs[0].data.heightfield = generator.GenerateHeightfield(resolution, worldSize);
 	}
 
 private:
 	PerlinNoiseGenerator generator;
+	int resolution = 128;    // Quads per side
+	float worldSize = 10.0f; // World units across
 };
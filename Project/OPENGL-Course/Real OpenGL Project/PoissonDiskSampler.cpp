@@ -0,0 +1,181 @@
+#include "PoissonDiskSampler.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace
+{
+	// Open-addressing hash from grid cell to the point stored in it
+	class CellHash
+	{
+	public:
+		explicit CellHash(size_t expectedPoints) { Allocate(expectedPoints * 2); }
+
+		void Insert(int cx, int cy, const glm::vec2& value)
+		{
+			// Keep the load factor at or below one half
+			if ((count + 1) * 2 > keys.size()) Grow();
+			Place(MakeKey(cx, cy), value);
+			count++;
+		}
+
+		const glm::vec2* Find(int cx, int cy) const
+		{
+			long long key = MakeKey(cx, cy);
+			for (size_t slot = Hash(key); keys[slot] != EMPTY; slot = (slot + 1) & mask)
+				if (keys[slot] == key) return &values[slot];
+			return nullptr;
+		}
+
+	private:
+		static constexpr long long EMPTY = 0x7fffffffffffffffLL;
+		std::vector<long long> keys;
+		std::vector<glm::vec2> values;
+		size_t mask = 0;
+		size_t count = 0;
+
+		void Allocate(size_t minSlots)
+		{
+			size_t size = 64;
+			while (size < minSlots) size <<= 1;
+			mask = size - 1;
+			keys.assign(size, EMPTY);
+			values.resize(size);
+		}
+
+		void Place(long long key, const glm::vec2& value)
+		{
+			size_t slot = Hash(key);
+			while (keys[slot] != EMPTY) slot = (slot + 1) & mask;
+			keys[slot] = key;
+			values[slot] = value;
+		}
+
+		void Grow()
+		{
+			std::vector<long long> oldKeys;
+			std::vector<glm::vec2> oldValues;
+			oldKeys.swap(keys);
+			oldValues.swap(values);
+			Allocate(oldKeys.size() * 2);
+			for (size_t i = 0; i < oldKeys.size(); i++)
+				if (oldKeys[i] != EMPTY) Place(oldKeys[i], oldValues[i]);
+		}
+
+		static long long MakeKey(int cx, int cy) { return ((long long)cx << 32) | (unsigned int)cy; }
+		size_t Hash(long long key) const
+		{
+			unsigned long long h = (unsigned long long)key * 0x9E3779B97F4A7C15ULL;
+			return (size_t)(h ^ (h >> 32)) & mask;
+		}
+	};
+
+	// 5x5 neighbourhood without its corners (a corner cell is at least one radius away), nearest first
+	const int NEIGHBOURS[21][2] = {
+		{ 0, 0 }, { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 },
+		{ -1, -1 }, { 1, -1 }, { -1, 1 }, { 1, 1 },
+		{ -2, 0 }, { 2, 0 }, { 0, -2 }, { 0, 2 },
+		{ -2, -1 }, { -2, 1 }, { 2, -1 }, { 2, 1 }, { -1, -2 }, { 1, -2 }, { -1, 2 }, { 1, 2 } };
+}
+
+double PoissonDiskSampler::MaxPointCount(const glm::vec2& boundsMin, const glm::vec2& boundsMax, float radius)
+{
+	glm::vec2 extent = boundsMax - boundsMin;
+	if (radius <= 0.0f || extent.x < 0.0f || extent.y < 0.0f) return 0.0;
+
+	// Discs of diameter 'radius' around each point never overlap; the densest packing covers
+	// pi / sqrt(12) of the rectangle grown by half a radius on each side
+	double area = ((double)extent.x + radius) * ((double)extent.y + radius);
+	return area * 2.0 / (std::sqrt(3.0) * (double)radius * radius) + 1.0;
+}
+
+float PoissonDiskSampler::RadiusForCount(double area, double count)
+{
+	if (area <= 0.0 || count <= 0.0) return 0.0f;
+	return (float)std::sqrt(SATURATED_DENSITY * area / count);
+}
+
+std::vector<glm::vec2> PoissonDiskSampler::Generate(const glm::vec2& boundsMin, const glm::vec2& boundsMax,
+	float radius, unsigned int seed, int attempts)
+{
+	std::vector<glm::vec2> points;
+	glm::vec2 extent = boundsMax - boundsMin;
+	if (radius <= 0.0f || attempts <= 0 || extent.x < 0.0f || extent.y < 0.0f) return points;
+
+	const float cellSize = radius / std::sqrt(2.0f);
+	const float radiusSq = radius * radius;
+
+	size_t expected = (size_t)std::min(SATURATED_DENSITY * (extent.x + radius) * (extent.y + radius) / (radius * radius), 1e7);
+	points.reserve(expected);
+	CellHash grid(expected);
+	std::vector<int> active;
+
+	// Candidates sit just outside the exclusion radius at evenly spaced angles from one random start
+	// angle (Roberts' variant of Bridson): denser packing and no per-candidate random draws
+	const float ringRadius = radius * 1.0001f;
+	std::vector<glm::vec2> directions(attempts);
+	for (int a = 0; a < attempts; a++)
+	{
+		float angle = 6.28318531f * (float)a / (float)attempts;
+		directions[a] = glm::vec2(std::cos(angle), std::sin(angle));
+	}
+
+	std::mt19937 gen(seed);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	auto cellOf = [&](const glm::vec2& p) { return glm::ivec2(glm::floor((p - boundsMin) / cellSize)); };
+	auto accept = [&](const glm::vec2& p)
+	{
+		glm::ivec2 c = cellOf(p);
+		grid.Insert(c.x, c.y, p);
+		active.push_back((int)points.size());
+		points.push_back(p);
+	};
+
+	accept(boundsMin + glm::vec2(unit(gen), unit(gen)) * extent);
+
+	while (!active.empty())
+	{
+		int slot = std::uniform_int_distribution<int>(0, (int)active.size() - 1)(gen);
+		glm::vec2 origin = points[active[slot]];
+
+		float start = unit(gen) * 6.28318531f;
+		glm::vec2 rot(std::cos(start), std::sin(start));
+
+		bool placed = false;
+		for (int a = 0; a < attempts && !placed; a++)
+		{
+			const glm::vec2& dir = directions[a];
+			glm::vec2 candidate = origin + ringRadius * glm::vec2(dir.x * rot.x - dir.y * rot.y, dir.x * rot.y + dir.y * rot.x);
+			if (candidate.x < boundsMin.x || candidate.y < boundsMin.y ||
+				candidate.x > boundsMax.x || candidate.y > boundsMax.y) continue;
+
+			glm::ivec2 c = cellOf(candidate);
+			bool clear = true;
+			for (int n = 0; n < 21 && clear; n++)
+			{
+				const glm::vec2* other = grid.Find(c.x + NEIGHBOURS[n][0], c.y + NEIGHBOURS[n][1]);
+				if (other)
+				{
+					glm::vec2 d = *other - candidate;
+					if (glm::dot(d, d) < radiusSq) clear = false;
+				}
+			}
+
+			if (clear)
+			{
+				accept(candidate);
+				placed = true;
+			}
+		}
+
+		// Exhausted its ring: retire it
+		if (!placed)
+		{
+			active[slot] = active.back();
+			active.pop_back();
+		}
+	}
+
+	return points;
+}
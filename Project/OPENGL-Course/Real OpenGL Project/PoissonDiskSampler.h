@@ -0,0 +1,28 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// Bridson's Poisson-disk sampling over a 2D rectangle: no two points closer than 'radius'.
+// Accepted points live in a spatial hash with cell size radius/sqrt(2) (at most one point per cell),
+// so rejecting a candidate checks a fixed 5x5 neighbourhood regardless of how many points exist.
+// Always runs to saturation, so the set covers the whole rectangle; callers wanting a given count
+// pick the radius for it (RadiusForCount). Deterministic for a given seed.
+class PoissonDiskSampler
+{
+public:
+	// 'attempts' candidates are tried around each active point before it is retired
+	static std::vector<glm::vec2> Generate(const glm::vec2& boundsMin, const glm::vec2& boundsMax,
+		float radius, unsigned int seed, int attempts = 30);
+
+	// Upper bound on how many points Generate can return (hexagonal packing density), for sizing
+	// and for rejecting radii too small for the domain before running
+	static double MaxPointCount(const glm::vec2& boundsMin, const glm::vec2& boundsMax, float radius);
+
+	// Saturated sets hold about this many points per radius^2 of area (measured; Roberts' ring packs
+	// tighter than classic Bridson's ~0.7)
+	static constexpr double SATURATED_DENSITY = 0.88;
+
+	// Radius whose saturated set fills 'area' with about 'count' points
+	static float RadiusForCount(double area, double count);
+};
@@ -12,26 +12,28 @@ MeshData PrimitiveGenerator::GetPlaneData(int resolutionX, int resolutionZ)
     
     int totalVerts = (resolutionX + 1) * (resolutionZ + 1);
     int totalIndices = resolutionX * resolutionZ * 6;
-    data.vertices.reserve(totalVerts * 14);
-    data.indices.reserve(totalIndices);
 
     float stepX = 2.0f / (float)resolutionX;
     float stepZ = 2.0f / (float)resolutionZ;
 
+    // Normal: (0, 1, 0), Tangent: (1, 0, 0), Bitangent: (0, 0, 1) for every vertex
+    VertexWriter w = data.AppendVertices(totalVerts);
+    int vi = 0;
     for (int z = 0; z <= resolutionZ; z++)
     {
-        for (int x = 0; x <= resolutionX; x++)
+        for (int x = 0; x <= resolutionX; x++, vi++)
         {
             float posX = -1.0f + (float)x * stepX;
             float posZ = -1.0f + (float)z * stepZ;
-            float u = (float)x / (float)resolutionX;
-            float v = (float)z / (float)resolutionZ;
-
-            // Normal: (0, 1, 0), Tangent: (1, 0, 0), Bitangent: (0, 0, 1)
-            data.AddVertex(posX, 0.0f, posZ, u, v, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+            w.positions[vi] = glm::vec3(posX, 0.0f, posZ);
+            w.uvs[vi] = glm::vec2((float)x / (float)resolutionX, (float)z / (float)resolutionZ);
+            w.normals[vi] = glm::vec3(0.0f, 1.0f, 0.0f);
+            w.tangents[vi] = glm::vec3(1.0f, 0.0f, 0.0f);
+            w.bitangents[vi] = glm::vec3(0.0f, 0.0f, 1.0f);
         }
     }
 
+    unsigned int* idx = data.AppendIndices(totalIndices);
     for (int z = 0; z < resolutionZ; z++)
     {
         for (int x = 0; x < resolutionX; x++)
@@ -41,8 +43,8 @@ MeshData PrimitiveGenerator::GetPlaneData(int resolutionX, int resolutionZ)
             unsigned int bottomLeft = (z + 1) * (resolutionX + 1) + x;
             unsigned int bottomRight = bottomLeft + 1;
 
-            data.AddTriangle(topLeft, bottomLeft, topRight);
-            data.AddTriangle(topRight, bottomLeft, bottomRight);
+            *idx++ = topLeft; *idx++ = bottomLeft; *idx++ = topRight;
+            *idx++ = topRight; *idx++ = bottomLeft; *idx++ = bottomRight;
         }
     }
 
@@ -98,7 +100,7 @@ MeshData PrimitiveGenerator::GetCubeData()
         16, 17, 18, 18, 19, 16,
         20, 21, 22, 22, 23, 20
     };
-    for (int i = 0; i < 36; i++) data.indices.push_back(indices[i]);
+    data.indices.assign(indices, indices + 36);
 
     return data;
 }
@@ -115,12 +117,11 @@ MeshData PrimitiveGenerator::GetSphereData(unsigned int rings, unsigned int sect
     
     int totalVerts = rings * sectors;
     int totalIndices = (rings - 1) * (sectors - 1) * 6;
-    data.vertices.reserve(totalVerts * 14);
-    data.indices.reserve(totalIndices);
-
     float const R = 1.0f / (float)(rings - 1);
     float const S = 1.0f / (float)(sectors - 1);
 
+    VertexWriter w = data.AppendVertices(totalVerts);
+    int vi = 0;
     for (unsigned int r = 0; r < rings; r++) {
         for (unsigned int s = 0; s < sectors; s++) {
             float y = sin(-M_PI / 2 + M_PI * r * R);
@@ -143,14 +144,20 @@ MeshData PrimitiveGenerator::GetSphereData(unsigned int rings, unsigned int sect
             float blen = sqrt(bx * bx + by * by + bz * bz);
             if (blen > 0.0f) { bx /= blen; by /= blen; bz /= blen; }
 
-            data.AddVertex(x, y, z, u, v, nx, ny, nz, tx, ty, tz, bx, by, bz);
+            w.positions[vi] = glm::vec3(x, y, z);
+            w.uvs[vi] = glm::vec2(u, v);
+            w.normals[vi] = glm::vec3(nx, ny, nz);
+            w.tangents[vi] = glm::vec3(tx, ty, tz);
+            w.bitangents[vi] = glm::vec3(bx, by, bz);
+            vi++;
         }
     }
 
+    unsigned int* idx = data.AppendIndices(totalIndices);
     for (unsigned int r = 0; r < rings - 1; r++) {
         for (unsigned int s = 0; s < sectors - 1; s++) {
-            data.AddTriangle(r * sectors + s, (r + 1) * sectors + s, (r + 1) * sectors + (s + 1));
-            data.AddTriangle(r * sectors + s, (r + 1) * sectors + (s + 1), r * sectors + (s + 1));
+            *idx++ = r * sectors + s; *idx++ = (r + 1) * sectors + s; *idx++ = (r + 1) * sectors + (s + 1);
+            *idx++ = r * sectors + s; *idx++ = (r + 1) * sectors + (s + 1); *idx++ = r * sectors + (s + 1);
         }
     }
     return data;
@@ -2,16 +2,28 @@
 #include "SceneManager.h"
 #include "Camera.h"
 #include "Window.h"
+#include "GameObject.h"
+#include "Mesh.h"
+#include "Material.h"
+#include "Texture.h"
+#include "TerrainStreamer.h"
+
+#include <map>
+#include <tuple>
 
 Renderer::Renderer()
 	: uniformModel(-1), uniformProjection(-1), uniformView(-1),
 	  uniformEyePosition(-1), uniformSpecularIntensity(-1), uniformShininess(-1),
-	  uniformOmniLightPos(-1), uniformFarPlane(-1), uniformUseNormalMap(-1)
+	  uniformOmniLightPos(-1), uniformFarPlane(-1), uniformUseNormalMap(-1),
+	  uniformUseInstancing(-1), uniformDirectionalUseInstancing(-1), uniformOmniUseInstancing(-1),
+	  instanceVBO(0), terrainStreamer(nullptr)
 {
 }
 
 Renderer::~Renderer()
 {
+	if (instanceVBO != 0)
+		glDeleteBuffers(1, &instanceVBO);
 }
 
 void Renderer::Init()
@@ -21,6 +33,8 @@ void Renderer::Init()
 	omniShadowShader.CreateFromFiles("Shaders/omni_shadow_map.vert", "Shaders/omni_shadow_map.geom", "Shaders/omni_shadow_map.frag");
 
 	CacheUniforms();
+
+	glGenBuffers(1, &instanceVBO);
 }
 
 void Renderer::LoadSkybox(const std::vector<std::string>& faces)
@@ -39,6 +53,92 @@ void Renderer::CacheUniforms()
 	uniformMaterialColor = glGetUniformLocation(mainShader.GetShaderID(), "material.baseColor");
 	uniformUseNormalMap = glGetUniformLocation(mainShader.GetShaderID(), "useNormalMap");
 	uniformUseDiffuseTexture = glGetUniformLocation(mainShader.GetShaderID(), "useDiffuseTexture");
+	uniformUseInstancing = glGetUniformLocation(mainShader.GetShaderID(), "useInstancing");
+	uniformDirectionalUseInstancing = glGetUniformLocation(directionalShadowShader.GetShaderID(), "useInstancing");
+	uniformOmniUseInstancing = glGetUniformLocation(omniShadowShader.GetShaderID(), "useInstancing");
+}
+
+void Renderer::BuildInstanceBatches(SceneManager& scene)
+{
+	instanceBatches.clear();
+	instanceMatrices.clear();
+
+	// Bucket plain mesh objects (models draw per mesh with their own textures) by render state
+	using BatchKey = std::tuple<Mesh*, Material*, Texture*, Texture*>;
+	std::map<BatchKey, std::vector<GameObject*>> groups;
+	for (auto* obj : scene.GetObjects())
+	{
+		obj->SetDrawnInstanced(false);
+		if (obj->GetModel() || !obj->GetMesh()) continue;
+		groups[BatchKey(obj->GetMesh(), obj->GetMaterial(), obj->GetTexture(), obj->GetNormalMap())].push_back(obj);
+	}
+
+	for (auto& entry : groups)
+	{
+		const std::vector<GameObject*>& members = entry.second;
+		if ((int)members.size() < MIN_INSTANCE_BATCH) continue;
+
+		InstanceBatch batch;
+		std::tie(batch.mesh, batch.material, batch.texture, batch.normalMap) = entry.first;
+		batch.firstInstance = (int)instanceMatrices.size();
+		batch.instanceCount = (int)members.size();
+		for (auto* obj : members)
+		{
+			instanceMatrices.push_back(obj->GetWorldMatrix());
+			obj->SetDrawnInstanced(true);
+		}
+		instanceBatches.push_back(batch);
+	}
+
+	if (instanceMatrices.empty()) return;
+
+	// One upload per frame, shared by the shadow passes and the main pass
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(glm::mat4) * instanceMatrices.size(), instanceMatrices.data(), GL_STREAM_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Renderer::DrawInstanceBatches(GLint useInstancingLocation, bool bindMaterials)
+{
+	if (instanceBatches.empty()) return;
+
+	glUniform1i(useInstancingLocation, 1);
+
+	for (auto& batch : instanceBatches)
+	{
+		// Same state setup as GameObject::Render for a plain mesh
+		if (bindMaterials)
+		{
+			if (batch.material)
+			{
+				batch.material->UseMaterial(uniformSpecularIntensity, uniformShininess, uniformMaterialColor);
+			}
+			else
+			{
+				glUniform1f(uniformSpecularIntensity, 0.0f);
+				glUniform1f(uniformShininess, 1.0f);
+				glUniform3f(uniformMaterialColor, 1.0f, 1.0f, 1.0f);
+			}
+
+			if (batch.texture) {
+				glUniform1i(uniformUseDiffuseTexture, 1);
+				batch.texture->UseTexture();
+			} else {
+				glUniform1i(uniformUseDiffuseTexture, 0);
+			}
+
+			if (batch.normalMap) {
+				glUniform1i(uniformUseNormalMap, 1);
+				batch.normalMap->UseNormalMap();
+			} else {
+				glUniform1i(uniformUseNormalMap, 0);
+			}
+		}
+
+		batch.mesh->RenderMeshInstanced(instanceVBO, (GLintptr)(sizeof(glm::mat4) * batch.firstInstance), batch.instanceCount);
+	}
+
+	glUniform1i(useInstancingLocation, 0);
 }
 
 void Renderer::DirectionalShadowMapPass(DirectionalLight* light, SceneManager& scene)
@@ -56,6 +156,8 @@ void Renderer::DirectionalShadowMapPass(DirectionalLight* light, SceneManager& s
 	directionalShadowShader.Validate();
 
 	scene.RenderAll(shadowModelLoc, -1, -1, -1, -1, -1);
+	DrawInstanceBatches(uniformDirectionalUseInstancing, false);
+	if (terrainStreamer) terrainStreamer->Render(shadowModelLoc);
 
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
@@ -80,6 +182,8 @@ void Renderer::OmniShadowMapPass(PointLight* light, SceneManager& scene)
 	omniShadowShader.Validate();
 
 	scene.RenderAll(shadowModelLoc, -1, -1, -1, -1, -1);
+	DrawInstanceBatches(uniformOmniUseInstancing, false);
+	if (terrainStreamer) terrainStreamer->Render(shadowModelLoc);
 
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
@@ -121,6 +225,18 @@ void Renderer::RenderPass(const glm::mat4& projection, const glm::mat4& view,
 
 	// Scene objects
 	scene.RenderAll(uniformModel, uniformSpecularIntensity, uniformShininess, uniformMaterialColor, uniformUseNormalMap, uniformUseDiffuseTexture);
+	DrawInstanceBatches(uniformUseInstancing, true);
+
+	// Streamed terrain: untextured, matte
+	if (terrainStreamer && terrainStreamer->IsEnabled())
+	{
+		glUniform1f(uniformSpecularIntensity, 0.0f);
+		glUniform1f(uniformShininess, 1.0f);
+		glUniform3f(uniformMaterialColor, 0.45f, 0.5f, 0.38f);
+		glUniform1i(uniformUseDiffuseTexture, 0);
+		glUniform1i(uniformUseNormalMap, 0);
+		terrainStreamer->Render(uniformModel);
+	}
 
 	// Clear depth only so icons/gizmos draw over scene but inter-occlude
 	glClear(GL_DEPTH_BUFFER_BIT);
@@ -15,6 +15,10 @@
 class SceneManager;
 class Camera;
 class Window;
+class Mesh;
+class Material;
+class Texture;
+class TerrainStreamer;
 
 class Renderer
 {
@@ -25,6 +29,10 @@ public:
 	void Init();
 	void LoadSkybox(const std::vector<std::string>& faces);
 
+	// Group mesh objects sharing Mesh+Material+Texture into instanced batches and upload their
+	// world matrices. Call once per frame before the passes; every pass reuses the result.
+	void BuildInstanceBatches(SceneManager& scene);
+
 	// Render passes
 	void DirectionalShadowMapPass(DirectionalLight* light, SceneManager& scene);
 	void OmniShadowMapPass(PointLight* light, SceneManager& scene);
@@ -37,6 +45,9 @@ public:
 
 	Shader& GetMainShader() { return mainShader; }
 
+	// Streamed terrain chunks are drawn in every pass alongside the scene (nullptr to disable)
+	void SetTerrainStreamer(TerrainStreamer* streamer) { terrainStreamer = streamer; }
+
 private:
 	Shader mainShader;
 	Shader directionalShadowShader;
@@ -47,6 +58,28 @@ private:
 	GLint uniformModel, uniformProjection, uniformView;
 	GLint uniformEyePosition, uniformSpecularIntensity, uniformShininess, uniformMaterialColor;
 	GLint uniformOmniLightPos, uniformFarPlane, uniformUseNormalMap, uniformUseDiffuseTexture;
+	GLint uniformUseInstancing, uniformDirectionalUseInstancing, uniformOmniUseInstancing;
+
+	// ========== Instancing ==========
+	struct InstanceBatch
+	{
+		Mesh* mesh = nullptr;
+		Material* material = nullptr;
+		Texture* texture = nullptr;
+		Texture* normalMap = nullptr;
+		int firstInstance = 0; // Offset into the instance buffer, in matrices
+		int instanceCount = 0;
+	};
+	std::vector<InstanceBatch> instanceBatches;
+	std::vector<glm::mat4> instanceMatrices;
+	GLuint instanceVBO;
+
+	TerrainStreamer* terrainStreamer;
+
+	// Groups smaller than this keep the regular per-object path
+	static const int MIN_INSTANCE_BATCH = 4;
+
+	void DrawInstanceBatches(GLint useInstancingLocation, bool bindMaterials);
 
 	void CacheUniforms();
 };
@@ -0,0 +1,147 @@
+#include "ScatterMaskNode.h"
+#include "ThreadPool.h"
+#include "stb_image.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+void ScatterMaskNode::RenderContent(SceneManager* scene)
+{
+	ImGui::PushID(this);
+
+	bool changed = false;
+	changed |= ImGui::Checkbox("Height", &useHeight);
+	if (useHeight)
+	{
+		changed |= ImGui::DragFloat("Min Height", &heightMin, 0.05f);
+		changed |= ImGui::DragFloat("Max Height", &heightMax, 0.05f);
+		changed |= ImGui::DragFloat("Height Falloff", &heightFalloff, 0.01f, 0.0f, 100.0f);
+	}
+
+	changed |= ImGui::Checkbox("Slope", &useSlope);
+	if (useSlope)
+	{
+		changed |= ImGui::DragFloat("Min Slope", &slopeMin, 0.5f, 0.0f, 90.0f);
+		changed |= ImGui::DragFloat("Max Slope", &slopeMax, 0.5f, 0.0f, 90.0f);
+		changed |= ImGui::DragFloat("Slope Falloff", &slopeFalloff, 0.1f, 0.0f, 45.0f);
+	}
+
+	changed |= ImGui::Checkbox("Texture", &useTexture);
+	if (useTexture)
+	{
+		changed |= ImGui::InputText("Mask Path", texturePath, sizeof(texturePath), ImGuiInputTextFlags_EnterReturnsTrue);
+		changed |= ImGui::Combo("Channel", &textureChannel, "Red\0Green\0Blue\0Alpha\0Luminance\0");
+	}
+
+	ImGui::Separator();
+	changed |= ImGui::Checkbox("Invert", &invert);
+	changed |= ImGui::Checkbox("Multiply Existing", &multiplyExisting);
+
+	if (changed) MarkDirty();
+
+	ImGui::PopID();
+}
+
+std::shared_ptr<const ScatterMaskNode::MaskImage> ScatterMaskNode::LoadMask(const std::string& path)
+{
+	std::lock_guard<std::mutex> lock(imageCache->mutex);
+	if (imageCache->image && imageCache->image->path == path)
+		return imageCache->image;
+
+	auto image = std::make_shared<MaskImage>();
+	image->path = path;
+	int channels = 0;
+	unsigned char* data = stbi_load(path.c_str(), &image->width, &image->height, &channels, 4);
+	if (data)
+	{
+		image->pixels.assign(data, data + (size_t)image->width * image->height * 4);
+		stbi_image_free(data);
+	}
+	else
+	{
+		printf("Scatter Mask: failed to load %s\n", path.c_str());
+		image->width = image->height = 0;
+	}
+
+	imageCache->image = image;
+	return image;
+}
+
+// 1 inside [lo, hi], easing to 0 over 'falloff' on either side
+static float Band(float x, float lo, float hi, float falloff)
+{
+	if (falloff <= 0.0f) return (x >= lo && x <= hi) ? 1.0f : 0.0f;
+	float below = glm::clamp((x - (lo - falloff)) / falloff, 0.0f, 1.0f);
+	float above = glm::clamp(((hi + falloff) - x) / falloff, 0.0f, 1.0f);
+	float t = std::min(below, above);
+	return t * t * (3.0f - 2.0f * t);
+}
+
+void ScatterMaskNode::Execute()
+{
+	outputs[0].data.Clear();
+	outputs[0].data.type = PinDataType::Mesh;
+
+	if (inputs[0].data.type != PinDataType::Mesh || inputs[0].data.meshData->IsEmpty()) return;
+
+	std::shared_ptr<const MaskImage> mask;
+	if (useTexture && texturePath[0] != '\0')
+	{
+		mask = LoadMask(texturePath);
+		if (mask->pixels.empty()) mask.reset();
+	}
+
+	// Copy of the surface with its weight stream (re)written
+	outputs[0].data.meshData = inputs[0].data.meshData;
+	MeshData& mesh = outputs[0].data.meshData.Write();
+	const bool combine = multiplyExisting && mesh.HasWeights();
+	mesh.EnsureWeights();
+
+	ThreadPool::Get().ParallelFor(0, mesh.GetVertexCount(), 16384, [&](int begin, int end)
+	{
+		for (int i = begin; i < end; i++)
+		{
+			float w = 1.0f;
+
+			if (useHeight)
+				w *= Band(mesh.positions[i].y, heightMin, heightMax, heightFalloff);
+
+			if (useSlope)
+			{
+				glm::vec3 n = mesh.normals[i];
+				float len = glm::length(n);
+				float slope = len > 0.0f ? glm::degrees(std::acos(glm::clamp(std::abs(n.y) / len, 0.0f, 1.0f))) : 90.0f;
+				w *= Band(slope, slopeMin, slopeMax, slopeFalloff);
+			}
+
+			if (mask)
+			{
+				// Bilinear over texel centres, u = 0 and u = 1 landing on the first and last texel.
+				// Only UVs outside [0, 1] repeat, so a [0, 1]-mapped plane keeps its own edge texels.
+				glm::vec2 uv = mesh.uvs[i];
+				for (int axis = 0; axis < 2; axis++)
+					if (uv[axis] < 0.0f || uv[axis] > 1.0f) uv[axis] -= std::floor(uv[axis]);
+				float fx = uv.x * (float)(mask->width - 1);
+				float fy = uv.y * (float)(mask->height - 1);
+				int x0 = (int)fx, y0 = (int)fy;
+				int x1 = std::min(x0 + 1, mask->width - 1), y1 = std::min(y0 + 1, mask->height - 1);
+				float tx = fx - (float)x0, ty = fy - (float)y0;
+				auto texel = [&](int x, int y)
+				{
+					const unsigned char* p = &mask->pixels[((size_t)y * mask->width + x) * 4];
+					if (textureChannel == 4) return (0.2126f * p[0] + 0.7152f * p[1] + 0.0722f * p[2]) / 255.0f;
+					return p[textureChannel] / 255.0f;
+				};
+				float top = texel(x0, y0) + (texel(x1, y0) - texel(x0, y0)) * tx;
+				float bottom = texel(x0, y1) + (texel(x1, y1) - texel(x0, y1)) * tx;
+				w *= top + (bottom - top) * ty;
+			}
+
+			if (invert) w = 1.0f - w;
+			mesh.weights[i] = combine ? mesh.weights[i] * w : w;
+		}
+	});
+
+	outputs[0].data.sourceObjectName = inputs[0].data.sourceObjectName;
+	outputs[0].data.transforms = inputs[0].data.transforms;
+}
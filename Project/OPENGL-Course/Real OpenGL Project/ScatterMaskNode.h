@@ -0,0 +1,70 @@
+#pragma once
+
+#include "NodeGraph.h"
+#include "imgui.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Writes the per-vertex weight channel of a mesh from height, slope and/or a texture mask.
+// ScatterNode reads the channel when building its sampling distribution, so masked-out regions
+// receive no candidates at all instead of being generated and discarded.
+// Input: Surface (Mesh), Output: Surface (Mesh, with weights)
+class ScatterMaskNode : public GraphNode
+{
+public:
+	ScatterMaskNode(NodeGraph& graph)
+	{
+		id = graph.NextNodeId();
+		title = "Scatter Mask";
+
+		Pin surfaceIn(graph.NextPinId(), PinDataType::Mesh, "Surface");
+		inputs.push_back(surfaceIn);
+
+		Pin surfaceOut(graph.NextPinId(), PinDataType::Mesh, "Surface");
+		outputs.push_back(surfaceOut);
+	}
+
+	void RenderContent(SceneManager* scene) override;
+	void Execute() override;
+	GraphNode* Clone() const override { return new ScatterMaskNode(*this); }
+
+private:
+	// Height band (surface-local Y)
+	bool useHeight = false;
+	float heightMin = 0.0f;
+	float heightMax = 5.0f;
+	float heightFalloff = 0.5f;
+
+	// Slope band (degrees from horizontal)
+	bool useSlope = true;
+	float slopeMin = 0.0f;
+	float slopeMax = 30.0f;
+	float slopeFalloff = 5.0f;
+
+	// Texture mask sampled at the vertex UV
+	bool useTexture = false;
+	char texturePath[256] = "";
+	int textureChannel = 0; // R, G, B, A, Luminance
+
+	bool invert = false;
+	bool multiplyExisting = true; // Combine with upstream weights instead of replacing them
+
+	// Decoded mask image, shared with execution clones and reloaded only when the path changes
+	struct MaskImage
+	{
+		std::string path;
+		int width = 0;
+		int height = 0;
+		std::vector<unsigned char> pixels; // RGBA8
+	};
+	struct ImageCache
+	{
+		std::mutex mutex;
+		std::shared_ptr<const MaskImage> image;
+	};
+	std::shared_ptr<ImageCache> imageCache = std::make_shared<ImageCache>();
+
+	std::shared_ptr<const MaskImage> LoadMask(const std::string& path);
+};
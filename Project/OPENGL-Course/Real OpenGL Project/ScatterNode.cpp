@@ -4,26 +4,124 @@
 #include "PrimitiveGenerator.h"
 #include "imgui.h"
 #include "ScatterNode.h"
+#include "ThreadPool.h"
+#include "PoissonDiskSampler.h"
+#include "CounterRng.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <optional>
 #include <random>
 
+namespace
+{
+	// Uniform spatial hash of spheres, each filed under the cell holding its centre. With cells at least
+	// twice the largest radius, anything overlapping a query lies in the 27 surrounding cells, so a test
+	// costs the local density rather than the number of spheres already placed.
+	class SphereHash
+	{
+	public:
+		SphereHash(float cellSize, int capacity) : invCellSize(1.0f / cellSize)
+		{
+			size_t size = 64;
+			while (size < (size_t)capacity * 2) size <<= 1;
+			mask = size - 1;
+			heads.assign(size, -1);
+		}
+
+		bool Overlaps(const glm::vec3& center, float radius) const
+		{
+			glm::ivec3 cell = CellOf(center);
+			for (int dz = -1; dz <= 1; dz++)
+				for (int dy = -1; dy <= 1; dy++)
+					for (int dx = -1; dx <= 1; dx++)
+					{
+						// Distinct cells may share a bucket; the distance test filters those out
+						for (int j = heads[Bucket(cell + glm::ivec3(dx, dy, dz))]; j >= 0; j = next[j])
+						{
+							float reach = radius + spheres[j].w;
+							glm::vec3 d = glm::vec3(spheres[j]) - center;
+							if (glm::dot(d, d) < reach * reach) return true;
+						}
+					}
+			return false;
+		}
+
+		void Insert(const glm::vec3& center, float radius)
+		{
+			size_t bucket = Bucket(CellOf(center));
+			next.push_back(heads[bucket]);
+			heads[bucket] = (int)spheres.size();
+			spheres.emplace_back(center, radius);
+		}
+
+	private:
+		float invCellSize;
+		size_t mask;
+		std::vector<int> heads;
+		std::vector<int> next;
+		std::vector<glm::vec4> spheres; // xyz centre, w radius
+
+		glm::ivec3 CellOf(const glm::vec3& p) const { return glm::ivec3(glm::floor(p * invCellSize)); }
+		size_t Bucket(const glm::ivec3& c) const
+		{
+			return (size_t)(((unsigned int)c.x * 73856093u) ^ ((unsigned int)c.y * 19349663u) ^ ((unsigned int)c.z * 83492791u)) & mask;
+		}
+	};
+}
+
 void ScatterNode::RenderContent(SceneManager* scene)
 {
 	ImGui::PushID(this);
 
-	ImGui::SliderInt("Count", &count, 1, 1000);
-	ImGui::DragFloat("Min Scale", &minScale, 0.01f, 0.01f, 10.0f);
-	ImGui::DragFloat("Max Scale", &maxScale, 0.01f, 0.01f, 10.0f);
-	ImGui::Checkbox("Random Rotation", &randomRotation);
-	ImGui::Checkbox("Align to Normal", &alignToNormal);
-	if (ImGui::InputInt("Seed", &seed)) {}
+	bool changed = false;
+	int distributionIndex = (int)distribution;
+	if (ImGui::Combo("Distribution", &distributionIndex, "Random\0Poisson Disk\0"))
+	{
+		distribution = (Distribution)distributionIndex;
+		changed = true;
+	}
+	if (distribution == Distribution::PoissonDisk)
+	{
+		int spaceIndex = (int)poissonSpace;
+		if (ImGui::Combo("Space", &spaceIndex, "World XZ\0Surface UV\0"))
+		{
+			poissonSpace = (PoissonSpace)spaceIndex;
+			changed = true;
+		}
+		changed |= ImGui::DragFloat("Min Distance", &minDistance, 0.01f, 0.001f, 100.0f);
+		float spacing = poissonStats->spacing.load();
+		if (spacing > minDistance * 1.001f)
+		{
+			if (poissonStats->memoryCapped.load())
+				ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.2f, 1.0f), "Spacing widened to %.3f (too many points for the surface)", spacing);
+			else
+				ImGui::TextDisabled("Spacing used: %.3f (Count spread over the surface)", spacing);
+		}
+	}
+	changed |= ImGui::DragInt(distribution == Distribution::PoissonDisk ? "Max Count" : "Count", &count, 1.0f, 1, 200000);
+	changed |= ImGui::DragFloat("Min Scale", &minScale, 0.01f, 0.01f, 10.0f);
+	changed |= ImGui::DragFloat("Max Scale", &maxScale, 0.01f, 0.01f, 10.0f);
+	changed |= ImGui::Checkbox("Random Rotation", &randomRotation);
+	changed |= ImGui::Checkbox("Align to Normal", &alignToNormal);
+	changed |= ImGui::Checkbox("Avoid Overlap", &avoidOverlap);
+	if (avoidOverlap)
+	{
+		changed |= ImGui::DragFloat("Padding", &overlapPadding, 0.01f, 0.0f, 100.0f);
+		if (distribution == Distribution::Random)
+			changed |= ImGui::SliderInt("Attempts", &overlapAttempts, 1, 64);
+	}
+	changed |= ImGui::InputInt("Seed", &seed);
 	ImGui::SameLine();
 	if (ImGui::Button("Rand"))
-		seed = std::rand();
+	{
+		seed = (int)(std::random_device{}() & 0x7fffffff);
+		changed = true;
+	}
 
 	ImGui::Separator();
-	ImGui::Checkbox("Spawn as Objects", &spawnAsObjects);
+	changed |= ImGui::Checkbox("Spawn as Objects", &spawnAsObjects);
 	if (spawnAsObjects && scene)
 	{
 		auto& objects = scene->GetObjects();
@@ -58,65 +156,20 @@ void ScatterNode::RenderContent(SceneManager* scene)
 				{
 					targetParentIndex = i;
 					targetParentName = objects[i]->GetName();
+					changed = true;
 				}
 			}
 			ImGui::EndCombo();
 		}
 	}
 
-	ImGui::PopID();
-}
-
-float ScatterNode::RandRange(float min, float max)
-{
-	// This is a legacy helper, but we'll use mt19937 for real work
-	float t = (float)std::rand() / (float)RAND_MAX;
-	return min + t * (max - min);
-}
-
-void ScatterNode::RandomPointOnMesh(const MeshData& mesh, glm::vec3& outPos, glm::vec3& outNormal)
-{
-	if (mesh.indices.empty() || mesh.vertices.empty())
-	{
-		outPos = glm::vec3(0.0f);
-		outNormal = glm::vec3(0.0f, 1.0f, 0.0f);
-		return;
-	}
-
-	// Pick a random triangle
-	int triCount = (int)mesh.indices.size() / 3;
-	int triIdx = std::rand() % triCount;
+	if (changed) MarkDirty();
 
-	unsigned int i0 = mesh.indices[triIdx * 3];
-	unsigned int i1 = mesh.indices[triIdx * 3 + 1];
-	unsigned int i2 = mesh.indices[triIdx * 3 + 2];
-
-	glm::vec3 v0 = mesh.GetPosition(i0);
-	glm::vec3 v1 = mesh.GetPosition(i1);
-	glm::vec3 v2 = mesh.GetPosition(i2);
-
-	// Random barycentric coordinates
-	float r1 = RandRange(0.0f, 1.0f);
-	float r2 = RandRange(0.0f, 1.0f);
-	if (r1 + r2 > 1.0f)
-	{
-		r1 = 1.0f - r1;
-		r2 = 1.0f - r2;
-	}
-	float r0 = 1.0f - r1 - r2;
-
-	outPos = v0 * r0 + v1 * r1 + v2 * r2;
-
-	// Interpolate normal
-	glm::vec3 n0 = mesh.GetNormal(i0);
-	glm::vec3 n1 = mesh.GetNormal(i1);
-	glm::vec3 n2 = mesh.GetNormal(i2);
-	outNormal = glm::normalize(n0 * r0 + n1 * r1 + n2 * r2);
+	ImGui::PopID();
 }
 
-void ScatterNode::MergeTransformed(const MeshData& objectMesh, const glm::vec3& pos,
-	const glm::vec3& rotation, const glm::vec3& scaleVec,
-	const glm::vec3& surfaceNormal, MeshData& output)
+glm::mat4 ScatterNode::InstanceMatrix(const glm::vec3& pos, const glm::vec3& rotation,
+	const glm::vec3& scaleVec, const glm::vec3& surfaceNormal) const
 {
 	// Build transform matrix
 	glm::mat4 model = glm::mat4(1.0f);
@@ -144,47 +197,262 @@ void ScatterNode::MergeTransformed(const MeshData& objectMesh, const glm::vec3&
 	// Apply scale
 	model = glm::scale(model, scaleVec);
 
-	// Normal matrix (inverse transpose of upper 3x3)
-	glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
+	return model;
+}
+
+std::shared_ptr<const AliasTable> ScatterNode::GetTriangleSampler(const CowPtr<MeshData>& surface)
+{
+	{
+		std::lock_guard<std::mutex> lock(samplerCache->mutex);
+		if (samplerCache->table && samplerCache->surface.SharesWith(surface))
+			return samplerCache->table;
+	}
+
+	// Triangle areas scaled by their mean vertex weight, computed in parallel for large surfaces
+	const MeshData& mesh = surface.Get();
+	int triCount = mesh.GetTriangleCount();
+	std::vector<float> areas(triCount);
+	ThreadPool::Get().ParallelFor(0, triCount, 8192, [&](int begin, int end)
+	{
+		for (int t = begin; t < end; t++)
+		{
+			unsigned int i0 = mesh.indices[t * 3], i1 = mesh.indices[t * 3 + 1], i2 = mesh.indices[t * 3 + 2];
+			glm::vec3 v0 = mesh.GetPosition(i0);
+			glm::vec3 v1 = mesh.GetPosition(i1);
+			glm::vec3 v2 = mesh.GetPosition(i2);
+			float weight = (mesh.GetWeight(i0) + mesh.GetWeight(i1) + mesh.GetWeight(i2)) / 3.0f;
+			areas[t] = 0.5f * glm::length(glm::cross(v1 - v0, v2 - v0)) * weight;
+		}
+	});
+
+	auto table = std::make_shared<AliasTable>();
+	table->Build(areas.data(), triCount);
 
-	// Merge vertices
-	int baseVertex = output.GetVertexCount();
-	int srcVertCount = objectMesh.GetVertexCount();
+	std::lock_guard<std::mutex> lock(samplerCache->mutex);
+	samplerCache->surface = surface;
+	samplerCache->table = table;
+	return table;
+}
 
-	for (int i = 0; i < srcVertCount; i++)
+std::vector<ScatterNode::SurfacePoint> ScatterNode::PoissonSurfacePoints(const MeshData& surface) const
+{
+	std::vector<SurfacePoint> result;
+	const bool useUV = (poissonSpace == PoissonSpace::SurfaceUV);
+	auto coord = [&](unsigned int v) { return useUV ? surface.uvs[v] : glm::vec2(surface.positions[v].x, surface.positions[v].z); };
+
+	int triCount = surface.GetTriangleCount();
+	glm::vec2 boundsMin(FLT_MAX), boundsMax(-FLT_MAX);
+	for (unsigned int v : surface.indices)
+	{
+		boundsMin = glm::min(boundsMin, coord(v));
+		boundsMax = glm::max(boundsMax, coord(v));
+	}
+
+	// Uniform grid of triangle lists (CSR) over the 2D bounds, about one triangle per cell
+	int gridRes = glm::clamp((int)std::sqrt((float)triCount), 1, 1024);
+	glm::vec2 extent = glm::max(boundsMax - boundsMin, glm::vec2(1e-6f));
+	glm::vec2 toCell = (float)gridRes / extent;
+	auto cellRange = [&](int t, glm::ivec2& lo, glm::ivec2& hi)
+	{
+		glm::vec2 a = coord(surface.indices[t * 3]), b = coord(surface.indices[t * 3 + 1]), c = coord(surface.indices[t * 3 + 2]);
+		lo = glm::clamp(glm::ivec2((glm::min(a, glm::min(b, c)) - boundsMin) * toCell), glm::ivec2(0), glm::ivec2(gridRes - 1));
+		hi = glm::clamp(glm::ivec2((glm::max(a, glm::max(b, c)) - boundsMin) * toCell), glm::ivec2(0), glm::ivec2(gridRes - 1));
+	};
+
+	std::vector<int> cellStart(gridRes * gridRes + 1, 0);
+	for (int t = 0; t < triCount; t++)
+	{
+		glm::ivec2 lo, hi;
+		cellRange(t, lo, hi);
+		for (int y = lo.y; y <= hi.y; y++)
+			for (int x = lo.x; x <= hi.x; x++)
+				cellStart[y * gridRes + x + 1]++;
+	}
+	for (int i = 0; i < gridRes * gridRes; i++) cellStart[i + 1] += cellStart[i];
+	std::vector<int> cellTris(cellStart.back());
+	std::vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+	for (int t = 0; t < triCount; t++)
 	{
-		int base = i * 14;
+		glm::ivec2 lo, hi;
+		cellRange(t, lo, hi);
+		for (int y = lo.y; y <= hi.y; y++)
+			for (int x = lo.x; x <= hi.x; x++)
+				cellTris[fill[y * gridRes + x]++] = t;
+	}
 
-		// Transform position
-		glm::vec4 p = model * glm::vec4(
-			objectMesh.vertices[base], objectMesh.vertices[base + 1], objectMesh.vertices[base + 2], 1.0f);
+	// Area that can keep points: triangle area in the sampling space times its mean weight
+	double keptArea = 0.0;
+	for (int t = 0; t < triCount; t++)
+	{
+		unsigned int i0 = surface.indices[t * 3], i1 = surface.indices[t * 3 + 1], i2 = surface.indices[t * 3 + 2];
+		glm::vec2 e1 = coord(i1) - coord(i0), e2 = coord(i2) - coord(i0);
+		double weight = (surface.GetWeight(i0) + surface.GetWeight(i1) + surface.GetWeight(i2)) / 3.0f;
+		keptArea += 0.5 * std::abs((double)e1.x * e2.y - (double)e1.y * e2.x) * glm::clamp(weight, 0.0, 1.0);
+	}
+	keptArea = std::min(keptArea, (double)extent.x * extent.y);
+	if (keptArea <= 0.0) return result;
+
+	// Bridson always saturates its bounds (stopping early would leave one clump around the first
+	// point), so the radius sets the work: widen it until the kept area holds about 'count' points
+	// plus a margin for the subsample, never below Min Distance
+	const double margin = 1.25;
+	float radius = std::max(minDistance, PoissonDiskSampler::RadiusForCount(keptArea, margin * count));
+	bool capped = false;
+
+	std::vector<SurfacePoint> lifted;
+	std::vector<float> weights;
+	std::vector<char> hit;
+	for (int pass = 0; ; pass++)
+	{
+		// A spacing too small for the bounds would not fit in memory
+		double bound = PoissonDiskSampler::MaxPointCount(boundsMin, boundsMax, radius);
+		if (bound > MAX_POISSON_POINTS)
+		{
+			radius *= (float)std::sqrt(bound / MAX_POISSON_POINTS);
+			capped = true;
+		}
 
-		// Keep UVs
-		float u = objectMesh.vertices[base + 3];
-		float v = objectMesh.vertices[base + 4];
+		std::vector<glm::vec2> samples = PoissonDiskSampler::Generate(boundsMin, boundsMax, radius, (unsigned int)seed);
 
-		// Transform normal
-		glm::vec3 n = glm::normalize(normalMatrix * glm::vec3(
-			objectMesh.vertices[base + 5], objectMesh.vertices[base + 6], objectMesh.vertices[base + 7]));
+		// Lift each sample onto the surface (XZ: the highest triangle under it, UV: the first containing it)
+		lifted.assign(samples.size(), SurfacePoint());
+		weights.assign(samples.size(), 1.0f);
+		hit.assign(samples.size(), 0);
+		ThreadPool::Get().ParallelFor(0, (int)samples.size(), 1024, [&](int begin, int end)
+		{
+			for (int i = begin; i < end; i++)
+			{
+				const glm::vec2& p = samples[i];
+				glm::ivec2 cell = glm::clamp(glm::ivec2((p - boundsMin) * toCell), glm::ivec2(0), glm::ivec2(gridRes - 1));
+				int c = cell.y * gridRes + cell.x;
+				for (int k = cellStart[c]; k < cellStart[c + 1]; k++)
+				{
+					int t = cellTris[k];
+					unsigned int i0 = surface.indices[t * 3], i1 = surface.indices[t * 3 + 1], i2 = surface.indices[t * 3 + 2];
+					glm::vec2 a = coord(i0), e1 = coord(i1) - a, e2 = coord(i2) - a, d = p - a;
+					float det = e1.x * e2.y - e1.y * e2.x;
+					if (std::abs(det) < 1e-12f) continue;
+					float w1 = (d.x * e2.y - d.y * e2.x) / det;
+					float w2 = (e1.x * d.y - e1.y * d.x) / det;
+					float w0 = 1.0f - w1 - w2;
+					const float eps = -1e-5f;
+					if (w0 < eps || w1 < eps || w2 < eps) continue;
+
+					glm::vec3 pos = surface.positions[i0] * w0 + surface.positions[i1] * w1 + surface.positions[i2] * w2;
+					if (hit[i] && (useUV || pos.y <= lifted[i].position.y)) continue;
+
+					glm::vec3 n = surface.normals[i0] * w0 + surface.normals[i1] * w1 + surface.normals[i2] * w2;
+					lifted[i].position = pos;
+					lifted[i].id = (uint32_t)i;
+					lifted[i].normal = glm::length(n) > 0.0f ? glm::normalize(n) : glm::vec3(0.0f, 1.0f, 0.0f);
+					weights[i] = surface.GetWeight(i0) * w0 + surface.GetWeight(i1) * w1 + surface.GetWeight(i2) * w2;
+					hit[i] = 1;
+					if (useUV) break;
+				}
+			}
+		});
 
-		// Transform tangent and bitangent
-		glm::vec3 t = glm::normalize(normalMatrix * glm::vec3(
-			objectMesh.vertices[base + 8], objectMesh.vertices[base + 9], objectMesh.vertices[base + 10]));
+		// Weighted surfaces thin the set: a point survives with probability equal to its weight, so masked
+		// regions stay empty and spacing never drops below the minimum
+		result.clear();
+		result.reserve(samples.size());
+		for (size_t i = 0; i < samples.size(); i++)
+		{
+			if (!hit[i]) continue;
+			if (surface.HasWeights() && CounterRng((uint32_t)seed, (uint32_t)i, RNG_THINNING).NextFloat() >= weights[i]) continue;
+			result.push_back(lifted[i]);
+		}
 
-		glm::vec3 b = glm::normalize(normalMatrix * glm::vec3(
-			objectMesh.vertices[base + 11], objectMesh.vertices[base + 12], objectMesh.vertices[base + 13]));
+		// Overlapping triangles or uneven weights can leave fewer survivors than the estimate:
+		// tighten towards Min Distance and run again (a few passes at most)
+		if ((int)result.size() >= count || capped || radius <= minDistance || pass == 3 || IsCancelled()) break;
+		float shrink = result.empty() ? 0.5f : (float)std::sqrt(result.size() / (margin * count));
+		radius = std::max(minDistance, radius * std::min(shrink, 0.9f));
+	}
+	poissonStats->spacing.store(radius);
+	poissonStats->memoryCapped.store(capped);
 
-		output.AddVertex(p.x, p.y, p.z, u, v, n.x, n.y, n.z, t.x, t.y, t.z, b.x, b.y, b.z);
+	// Uniform subsample down to 'count': keep the points with the lowest random keys, in id order
+	if ((int)result.size() > count)
+	{
+		std::vector<std::pair<uint32_t, uint32_t>> ranked(result.size());
+		for (size_t k = 0; k < result.size(); k++)
+			ranked[k] = { CounterRng((uint32_t)seed, result[k].id, RNG_SUBSAMPLE).NextUInt(), (uint32_t)k };
+		std::nth_element(ranked.begin(), ranked.begin() + count, ranked.end());
+		std::vector<uint32_t> keep(count);
+		for (int k = 0; k < count; k++) keep[k] = ranked[k].second;
+		std::sort(keep.begin(), keep.end());
+
+		std::vector<SurfacePoint> subset(count);
+		for (int k = 0; k < count; k++) subset[k] = result[keep[k]];
+		result.swap(subset);
 	}
+	return result;
+}
+
+ScatterNode::SurfacePoint ScatterNode::RandomSurfacePoint(const MeshData& surface, const AliasTable& triSampler, uint32_t id) const
+{
+	CounterRng rng((uint32_t)seed, id, RNG_PLACEMENT);
+
+	// Pick a random triangle, weighted by area
+	float u0 = rng.NextFloat();
+	int triIdx = triSampler.Sample(u0, rng.NextFloat());
+	unsigned int i0 = surface.indices[triIdx * 3];
+	unsigned int i1 = surface.indices[triIdx * 3 + 1];
+	unsigned int i2 = surface.indices[triIdx * 3 + 2];
+
+	glm::vec3 v0 = surface.GetPosition(i0);
+	glm::vec3 v1 = surface.GetPosition(i1);
+	glm::vec3 v2 = surface.GetPosition(i2);
 
-	// Merge indices (offset by base vertex)
-	for (int i = 0; i < (int)objectMesh.indices.size(); i++)
+	// Random barycentric coordinates
+	float r0, r1, r2;
+	if (!surface.HasWeights())
 	{
-		output.indices.push_back(objectMesh.indices[i] + baseVertex);
+		r1 = rng.NextFloat();
+		r2 = rng.NextFloat();
+		if (r1 + r2 > 1.0f)
+		{
+			r1 = 1.0f - r1;
+			r2 = 1.0f - r2;
+		}
+		r0 = 1.0f - r1 - r2;
 	}
+	else
+	{
+		// Density linear in the vertex weights: a mixture of Dirichlet(2,1,1)-style components,
+		// component k chosen with probability w_k / sum(w). Exact, no rejection.
+		float w0 = surface.GetWeight(i0), w1 = surface.GetWeight(i1), w2 = surface.GetWeight(i2);
+		float pick = rng.NextFloat() * (w0 + w1 + w2);
+		int k = pick < w0 ? 0 : (pick < w0 + w1 ? 1 : 2);
+
+		float g[3];
+		for (int c = 0; c < 3; c++) g[c] = -std::log(1.0f - rng.NextFloat());
+		g[k] -= std::log(1.0f - rng.NextFloat()); // Gamma(2) = sum of two Exp(1)
+		float sum = g[0] + g[1] + g[2];
+		r0 = g[0] / sum;
+		r1 = g[1] / sum;
+		r2 = g[2] / sum;
+	}
+
+	// Interpolate normal
+	glm::vec3 n0 = surface.GetNormal(i0);
+	glm::vec3 n1 = surface.GetNormal(i1);
+	glm::vec3 n2 = surface.GetNormal(i2);
+
+	return { v0 * r0 + v1 * r1 + v2 * r2, glm::normalize(n0 * r0 + n1 * r1 + n2 * r2), id };
+}
+
+void ScatterNode::InstanceAttributes(uint32_t id, float& scale, glm::vec3& rotation) const
+{
+	CounterRng rng((uint32_t)seed, id, RNG_ATTRIBUTES);
+	scale = rng.NextFloat(minScale, maxScale);
+	rotation = glm::vec3(0.0f);
+	if (randomRotation)
+		rotation.y = rng.NextFloat(0.0f, 360.0f);
 }
 
-void ScatterNode::Execute(SceneManager& scene)
+void ScatterNode::Execute()
 {
 	lastTransforms.clear();
 	outputs[0].data.Clear(); // Combined
@@ -193,118 +461,195 @@ void ScatterNode::Execute(SceneManager& scene)
 	outputs[1].data.type = PinDataType::Mesh;
 
 	// Get surface mesh from input 0
-	MeshData& surfaceMesh = inputs[0].data.meshData;
+	const MeshData& surfaceMesh = inputs[0].data.meshData.Get();
 	// Get object mesh from input 1
-	MeshData& objectMesh = inputs[1].data.meshData;
+	const MeshData& objectMesh = inputs[1].data.meshData.Get();
 
-	bool hasSurface = (inputs[0].data.type == PinDataType::Mesh && !surfaceMesh.vertices.empty());
-	bool hasObject = (inputs[1].data.type == PinDataType::Mesh && !objectMesh.vertices.empty());
+	bool hasSurface = (inputs[0].data.type == PinDataType::Mesh && !surfaceMesh.IsEmpty());
+	bool hasObject = (inputs[1].data.type == PinDataType::Mesh && !objectMesh.IsEmpty());
 
 	if (!hasSurface || !hasObject)
 	{
 		// If no object mesh connected, just pass through the surface to Combined
-		if (hasSurface) outputs[0].data.meshData = surfaceMesh;
+		if (hasSurface) outputs[0].data.meshData = inputs[0].data.meshData;
 		return;
 	}
 
-	// Use a modern random engine to avoid biased std::rand()
-	std::mt19937 gen(seed);
-	std::uniform_int_distribution<> triDist(0, (int)surfaceMesh.indices.size() / 3 - 1);
-	std::uniform_real_distribution<float> floatDist(0.0f, 1.0f);
-	std::uniform_real_distribution<float> rotDist(0.0f, 360.0f);
-	std::uniform_real_distribution<float> scaleDist(minScale, maxScale);
+	// Every random draw comes from a counter-based stream keyed by (seed, instance, purpose), so the
+	// layout is identical however the instances are split across threads
+	ThreadPool& pool = ThreadPool::Get();
 
-	MeshData combinedResult = surfaceMesh;
-	MeshData instancesOnly;
-
-	int addedVerts = count * objectMesh.GetVertexCount();
-	int addedIndices = count * objectMesh.indices.size();
-	
-	combinedResult.vertices.reserve(combinedResult.vertices.size() + addedVerts * 14);
-	combinedResult.indices.reserve(combinedResult.indices.size() + addedIndices);
-	instancesOnly.vertices.reserve(addedVerts * 14);
-	instancesOnly.indices.reserve(addedIndices);
-
-	// Setup modular output lists
-	outputs[1].data.transforms.reserve(count);
-	outputs[1].data.instanceMeshes.reserve(count);
+	// Setup modular output lists: every instance references the object mesh as prototype 0,
+	// so the pin holds one shared buffer no matter how many transforms follow
+	TransformList& instanceTransforms = outputs[1].data.transforms.Write();
+	outputs[1].data.prototypes.push_back(inputs[1].data.meshData);
 
 	// Calculate surface world matrix (excluding scale, because scale is baked into vertices)
 	glm::mat4 surfaceWorldNoScale = glm::mat4(1.0f);
-	if (!inputs[0].data.transforms.empty())
+	if (!inputs[0].data.transforms->empty())
 	{
-		const TransformData& st = inputs[0].data.transforms[0];
+		const TransformData& st = inputs[0].data.transforms.Get()[0];
 		surfaceWorldNoScale = glm::translate(surfaceWorldNoScale, st.position);
 		surfaceWorldNoScale = glm::rotate(surfaceWorldNoScale, glm::radians(st.rotation.x), glm::vec3(1, 0, 0));
 		surfaceWorldNoScale = glm::rotate(surfaceWorldNoScale, glm::radians(st.rotation.y), glm::vec3(0, 1, 0));
 		surfaceWorldNoScale = glm::rotate(surfaceWorldNoScale, glm::radians(st.rotation.z), glm::vec3(0, 0, 1));
 	}
 
-	for (int i = 0; i < count; i++)
+	// Overlap rejection uses the prototype's bounding sphere (AABB centre, farthest vertex), computed once.
+	// The sphere hash is only built when overlaps are tested; tryAccept is only called on those paths.
+	glm::vec3 boundsCenter(0.0f);
+	float boundsRadius = 0.0f;
+	std::optional<SphereHash> occupied;
+	if (avoidOverlap)
 	{
-		// Pick a random triangle properly
-		int triIdx = triDist(gen);
-		unsigned int i0 = surfaceMesh.indices[triIdx * 3];
-		unsigned int i1 = surfaceMesh.indices[triIdx * 3 + 1];
-		unsigned int i2 = surfaceMesh.indices[triIdx * 3 + 2];
-
-		glm::vec3 v0 = surfaceMesh.GetPosition(i0);
-		glm::vec3 v1 = surfaceMesh.GetPosition(i1);
-		glm::vec3 v2 = surfaceMesh.GetPosition(i2);
-
-		// Random barycentric coordinates
-		float r1 = floatDist(gen);
-		float r2 = floatDist(gen);
-		if (r1 + r2 > 1.0f)
+		glm::vec3 lo(FLT_MAX), hi(-FLT_MAX);
+		for (const glm::vec3& v : objectMesh.positions)
 		{
-			r1 = 1.0f - r1;
-			r2 = 1.0f - r2;
+			lo = glm::min(lo, v);
+			hi = glm::max(hi, v);
 		}
-		float r0 = 1.0f - r1 - r2;
-
-		glm::vec3 localPos = v0 * r0 + v1 * r1 + v2 * r2;
+		boundsCenter = 0.5f * (lo + hi);
+		for (const glm::vec3& v : objectMesh.positions)
+			boundsRadius = std::max(boundsRadius, glm::length(v - boundsCenter));
 
-		// Interpolate normal
-		glm::vec3 n0 = surfaceMesh.GetNormal(i0);
-		glm::vec3 n1 = surfaceMesh.GetNormal(i1);
-		glm::vec3 n2 = surfaceMesh.GetNormal(i2);
-		glm::vec3 localNormal = glm::normalize(n0 * r0 + n1 * r1 + n2 * r2);
+		float largestRadius = boundsRadius * std::max(minScale, maxScale) + 0.5f * overlapPadding;
+		occupied.emplace(std::max(2.0f * largestRadius, 1e-4f), count);
+	}
 
-		// Transform to World Space
-		glm::vec3 worldPos = glm::vec3(surfaceWorldNoScale * glm::vec4(localPos, 1.0f));
-		glm::vec3 worldNormal = glm::normalize(glm::mat3(surfaceWorldNoScale) * localNormal);
+	auto tryAccept = [&](const SurfacePoint& p)
+	{
+		float s;
+		glm::vec3 rot;
+		InstanceAttributes(p.id, s, rot);
+		glm::vec3 center = glm::vec3(InstanceMatrix(p.position, rot, glm::vec3(s), p.normal) * glm::vec4(boundsCenter, 1.0f));
+		float radius = boundsRadius * s + 0.5f * overlapPadding;
+		if (occupied->Overlaps(center, radius)) return false;
+		occupied->Insert(center, radius);
+		return true;
+	};
+
+	// Where instances go, in surface-local space
+	std::vector<SurfacePoint> placements;
+	if (distribution == Distribution::PoissonDisk)
+	{
+		placements = PoissonSurfacePoints(surfaceMesh);
+		if (avoidOverlap)
+		{
+			// Poisson spacing may be tighter than the object; keep the first of any overlapping pair
+			std::vector<SurfacePoint> kept;
+			kept.reserve(placements.size());
+			for (const SurfacePoint& p : placements)
+				if (tryAccept(p)) kept.push_back(p);
+			placements.swap(kept);
+		}
+	}
+	else
+	{
+		// Triangles are picked proportionally to their area (times their weight), so density is even on
+		// irregular meshes and fully masked triangles are never picked
+		std::shared_ptr<const AliasTable> triSampler = GetTriangleSampler(inputs[0].data.meshData);
+		int draws = triSampler->GetTotalWeight() > 0.0 ? count : 0;
 
-		// Random scale
-		float s = scaleDist(gen);
-		glm::vec3 scaleVec(s);
+		auto generate = [&](uint32_t firstId, int n, std::vector<SurfacePoint>& out)
+		{
+			out.resize(n);
+			pool.ParallelFor(0, n, INSTANCE_GRAIN, [&](int begin, int end)
+			{
+				if (IsCancelled()) return;
+				for (int k = begin; k < end; k++)
+					out[k] = RandomSurfacePoint(surfaceMesh, *triSampler, firstId + (uint32_t)k);
+			});
+		};
 
-		// Random rotation
-		glm::vec3 rot(0.0f);
-		if (randomRotation)
+		if (!avoidOverlap)
 		{
-			rot.y = rotDist(gen);
+			generate(0, draws, placements);
 		}
+		else
+		{
+			// Candidates are generated in parallel batches, accepted serially in id order (deterministic)
+			// until 'count' fit or the attempt budget runs out
+			placements.clear();
+			placements.reserve(draws);
+			long long budget = (long long)draws * std::max(1, overlapAttempts);
+			uint32_t nextId = 0;
+			std::vector<SurfacePoint> batch;
+			while ((int)placements.size() < draws && nextId < budget)
+			{
+				if (IsCancelled()) return;
+				ReportProgress((float)placements.size() / (float)draws);
 
-		// Store transform for modular downstream use (World Space!)
-		TransformData t;
-		t.position = worldPos;
-		t.rotation = rot; // Note: rotation might need to be added to surface rotation if total-world-rot desired
-		t.scale = scaleVec;
-		t.normal = worldNormal;
-		
-		lastTransforms.push_back(t); // Compatibility
-		outputs[1].data.transforms.push_back(t);
-		outputs[1].data.instanceMeshes.push_back(objectMesh); 
-
-		// Compute baked result (these stay local to the merged mesh)
-		MergeTransformed(objectMesh, localPos, rot, scaleVec, localNormal, combinedResult);
-		MergeTransformed(objectMesh, localPos, rot, scaleVec, localNormal, instancesOnly);
+				int n = (int)std::min<long long>(std::max(256, (draws - (int)placements.size()) * 2), budget - nextId);
+				generate(nextId, n, batch);
+				nextId += (uint32_t)n;
+				for (const SurfacePoint& p : batch)
+				{
+					if (!tryAccept(p)) continue;
+					placements.push_back(p);
+					if ((int)placements.size() == draws) break;
+				}
+			}
+		}
 	}
 
-	outputs[0].data.meshData = combinedResult;
+	if (IsCancelled()) return;
+
+	// Per-instance scale/rotation and matrices, written by index (baking happens afterwards in one batched pass)
+	int placed = (int)placements.size();
+	std::vector<glm::mat4> instanceMatrices(placed);
+	instanceTransforms.resize(placed);
+	std::atomic<int> done(0);
+
+	pool.ParallelFor(0, placed, INSTANCE_GRAIN, [&](int begin, int end)
+	{
+		if (IsCancelled()) return;
+
+		for (int i = begin; i < end; i++)
+		{
+			glm::vec3 localPos = placements[i].position;
+			glm::vec3 localNormal = placements[i].normal;
+
+			// Transform to World Space
+			glm::vec3 worldPos = glm::vec3(surfaceWorldNoScale * glm::vec4(localPos, 1.0f));
+			glm::vec3 worldNormal = glm::normalize(glm::mat3(surfaceWorldNoScale) * localNormal);
+
+			// Random scale and rotation
+			float s;
+			glm::vec3 rot;
+			InstanceAttributes(placements[i].id, s, rot);
+			glm::vec3 scaleVec(s);
+
+			// Store transform for modular downstream use (World Space!)
+			TransformData& t = instanceTransforms[i];
+			t.position = worldPos;
+			t.rotation = rot; // Note: rotation might need to be added to surface rotation if total-world-rot desired
+			t.scale = scaleVec;
+			t.normal = worldNormal;
+
+			// Baked result stays local to the merged mesh
+			instanceMatrices[i] = InstanceMatrix(localPos, rot, scaleVec, localNormal);
+		}
+
+		ReportProgress((float)(done += end - begin) / (float)placed);
+	});
+
+	if (IsCancelled()) return;
+	lastTransforms = instanceTransforms; // Compatibility
+
+	// Bake every instance once, then build Combined as surface + instances (plain stream copies)
+	MeshData instancesOnly;
+	instancesOnly.AppendInstances(objectMesh, instanceMatrices.data(), (int)instanceMatrices.size());
+
+	MeshData combinedResult;
+	combinedResult.Reserve(surfaceMesh.GetVertexCount() + instancesOnly.GetVertexCount(),
+		(int)(surfaceMesh.indices.size() + instancesOnly.indices.size()));
+	combinedResult.Append(surfaceMesh);
+	combinedResult.Append(instancesOnly);
+
+	outputs[0].data.meshData = std::move(combinedResult);
 	outputs[0].data.sourceObjectName = inputs[0].data.sourceObjectName;
 	outputs[0].data.transforms = inputs[0].data.transforms; // Propagate surface transform for OutputNode scale-back
 
-	outputs[1].data.meshData = instancesOnly;
+	outputs[1].data.meshData = std::move(instancesOnly);
 	outputs[1].data.sourceObjectName = "(none)"; 
 }
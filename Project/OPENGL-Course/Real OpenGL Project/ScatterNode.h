@@ -3,14 +3,18 @@
 #include "NodeGraph.h"
 #include "imgui.h"
 #include "PerlinNoiseGenerator.h"
+#include "AliasTable.h"
 #include <cmath>
-#include <cstdlib>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-// Scatters instances of an object mesh across a surface mesh.
+// Scatters instances of an object mesh across a surface mesh, either by area-weighted random draws
+// or as a Poisson-disk (minimum distance) set in world XZ or surface UV space.
 // Inputs: Surface (Mesh), Object (Mesh)
 // Outputs: Combined (Mesh) — all instances merged into one mesh
 class ScatterNode : public GraphNode
@@ -35,43 +39,99 @@ public:
 	}
 
 	void RenderContent(SceneManager* scene) override;
-	void Execute(SceneManager& scene) override;
+	void Execute() override;
+	GraphNode* Clone() const override { return new ScatterNode(*this); }
 
 private:
-	int count = 50;
+	enum class Distribution { Random, PoissonDisk };
+	enum class PoissonSpace { WorldXZ, SurfaceUV };
+
+	Distribution distribution = Distribution::Random;
+	PoissonSpace poissonSpace = PoissonSpace::WorldXZ;
+	float minDistance = 0.5f; // Poisson-disk spacing, in surface units (XZ) or UV units
+
+	int count = 50; // Exact count for Random, upper bound for Poisson-disk
 	float minScale = 0.8f;
 	float maxScale = 1.2f;
 	bool randomRotation = true;
 	bool alignToNormal = true;
 	int seed = 42;
 
+	// Overlap rejection: candidates whose scaled bounding sphere hits an accepted instance are dropped
+	bool avoidOverlap = false;
+	float overlapPadding = 0.0f; // Extra gap kept between instances
+	int overlapAttempts = 8;     // Random mode: candidates tried per requested instance
+
 	// Spawning Settings
 	bool spawnAsObjects = false;
 	std::string targetParentName = "(none)";
 	int targetParentIndex = -1;
-	std::vector<std::string> spawnedNames;
+	unsigned int spawnHandle = 0; // SceneManager spawn owner tagging the objects this node created
+	std::vector<Mesh*> spawnedMeshes; // GPU prototypes shared by the spawned objects
 	
 	TransformList lastTransforms; 
 
-	// Random float in [min, max]
-	float RandRange(float min, float max);
+	// Area-weighted triangle sampler for the last surface seen. Shared with execution clones so a
+	// background run can reuse (and refresh) it; rebuilt only when the surface buffer changes.
+	struct SamplerCache
+	{
+		std::mutex mutex;
+		CowPtr<MeshData> surface;
+		std::shared_ptr<const AliasTable> table;
+	};
+	std::shared_ptr<SamplerCache> samplerCache = std::make_shared<SamplerCache>();
+
+	std::shared_ptr<const AliasTable> GetTriangleSampler(const CowPtr<MeshData>& surface);
+
+	// Spacing the last Poisson-disk run actually used (Min Distance or wider), shown next to Min Distance.
+	// Shared with execution clones like the sampler cache.
+	struct PoissonStats
+	{
+		std::atomic<float> spacing{ 0.0f };
+		std::atomic<bool> memoryCapped{ false };
+	};
+	std::shared_ptr<PoissonStats> poissonStats = std::make_shared<PoissonStats>();
+
+	// CounterRng streams (one per purpose, so adding a draw to one pass never shifts another)
+	static const uint32_t RNG_PLACEMENT = 0;
+	static const uint32_t RNG_ATTRIBUTES = 1;
+	static const uint32_t RNG_THINNING = 2;
+	static const uint32_t RNG_SUBSAMPLE = 3;
+	static const int INSTANCE_GRAIN = 1024; // instances per parallel chunk
+	static constexpr double MAX_POISSON_POINTS = 2000000.0; // Poisson set size before the spacing is widened
+
+	// A placement on the surface, in the surface mesh's local space
+	struct SurfacePoint
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+		uint32_t id; // Candidate index; keys the instance's random streams
+	};
+
+	// Random-mode candidate 'id': area-weighted triangle, then a point inside it
+	SurfacePoint RandomSurfacePoint(const MeshData& surface, const AliasTable& triSampler, uint32_t id) const;
+
+	// Scale and rotation of candidate 'id' (the same values whether or not overlaps are tested)
+	void InstanceAttributes(uint32_t id, float& scale, glm::vec3& rotation) const;
 
-	// Pick a random point on a triangle mesh surface
-	// Returns position and face normal
-	void RandomPointOnMesh(const MeshData& mesh, glm::vec3& outPos, glm::vec3& outNormal);
+	// Min-distance points in the chosen 2D space: a saturated set over the whole surface at a spacing sized
+	// for 'count', lifted onto it (points over holes are dropped), thinned by weight, then uniformly
+	// subsampled down to 'count'
+	std::vector<SurfacePoint> PoissonSurfacePoints(const MeshData& surface) const;
 
-	// Transform an object mesh by position, rotation, scale and merge into output
-	void MergeTransformed(const MeshData& objectMesh, const glm::vec3& pos,
-		const glm::vec3& rotation, const glm::vec3& scale,
-		const glm::vec3& surfaceNormal, MeshData& output);
+	// Local matrix that places one instance at 'pos' with the given rotation/scale (optionally normal-aligned)
+	glm::mat4 InstanceMatrix(const glm::vec3& pos, const glm::vec3& rotation,
+		const glm::vec3& scale, const glm::vec3& surfaceNormal) const;
 
 public:
 	bool IsAlignToNormal() const { return alignToNormal; }
 	bool IsSpawnMode() const { return spawnAsObjects; }
 	int GetParentIndex() const { return targetParentIndex; }
 	std::string GetParentName() const { return targetParentName; }
-	const std::vector<std::string>& GetSpawnedNames() const { return spawnedNames; }
-	void SetSpawnedNames(const std::vector<std::string>& names) { spawnedNames = names; }
+	unsigned int GetSpawnHandle() const { return spawnHandle; }
+	void SetSpawnHandle(unsigned int handle) { spawnHandle = handle; }
+	const std::vector<Mesh*>& GetSpawnedMeshes() const { return spawnedMeshes; }
+	void SetSpawnedMeshes(const std::vector<Mesh*>& meshes) { spawnedMeshes = meshes; }
 
 	// Setters for programmatic setup (templates)
 	void SetSpawnAsObjects(bool value) { spawnAsObjects = value; }
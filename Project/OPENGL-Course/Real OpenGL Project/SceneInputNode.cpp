@@ -56,74 +56,103 @@ void SceneInputNode::RenderContent(SceneManager* scene)
 			{
 				selectedIndex = i;
 				selectedName = objects[i]->GetName();
+				MarkDirty();
 			}
 		}
 		ImGui::EndCombo();
 	}
 }
 
-void SceneInputNode::Execute(SceneManager& scene)
+SceneInputNode::SourceState SceneInputNode::CaptureSource(SceneManager& scene) const
 {
-	outputs[0].data.Clear();
-	outputs[0].data.type = PinDataType::Mesh;
+	SourceState state;
+	auto& objects = scene.GetObjects();
+	if (selectedName != "(none)" && selectedIndex >= 0 && selectedIndex < (int)objects.size())
+	{
+		const GameObject* obj = objects[selectedIndex];
+		state.object = obj;
+		state.model = obj->GetModel();
+		state.position = obj->GetTransform().GetPosition();
+		state.rotation = obj->GetTransform().GetRotation();
+		state.scale = obj->GetTransform().GetScale();
+	}
+	return state;
+}
 
-	if (selectedName == "(none)") return;
+void SceneInputNode::CheckSceneChanges(SceneManager& scene)
+{
+	SourceState current = CaptureSource(scene);
+	if (!(current == lastSource))
+	{
+		lastSource = current;
+		MarkDirty();
+	}
+}
 
-	MeshData data;
-	bool found = false;
+void SceneInputNode::PrepareExecute(SceneManager& scene)
+{
+	snapshot = SourceSnapshot();
+	if (selectedName == "(none)") return;
 
 	// Check if it's a primitive or a scene object
 	auto& objects = scene.GetObjects();
-	if (selectedIndex >= 0 && selectedIndex < (int)objects.size())
+	if (selectedIndex < 0 || selectedIndex >= (int)objects.size()) return;
+
+	GameObject* obj = objects[selectedIndex];
+
+	// 1. Try to retrieve persisted procedural mesh data if available
+	if (obj->HasCustomMesh())
 	{
-		GameObject* obj = objects[selectedIndex];
-		
-		// 1. Try to retrieve persisted procedural mesh data if available
-		if (obj->HasCustomMesh())
-		{
-			data = obj->GetCPUMeshData();
-			found = true;
-		}
-		// 2. Fallback to primitive data if it matches standard names
-		else if (selectedName.find("Plane") != std::string::npos) { data = PrimitiveGenerator::GetPlaneData(); found = true; }
-		else if (selectedName.find("Sphere") != std::string::npos) { data = PrimitiveGenerator::GetSphereData(); found = true; }
-		else if (selectedName.find("Cube") != std::string::npos) { data = PrimitiveGenerator::GetCubeData(); found = true; }
-		// 3. Extract from Model if available (for loaded assets)
-		else if (obj->GetModel() && !obj->GetModel()->GetMeshDataList().empty())
-		{
-			const auto& meshes = obj->GetModel()->GetMeshDataList();
-			for (const auto& m : meshes)
-			{
-				int baseIdx = (int)data.vertices.size() / 14;
-				data.vertices.insert(data.vertices.end(), m.vertices.begin(), m.vertices.end());
-				for (unsigned int idx : m.indices)
-				{
-					data.indices.push_back(idx + baseIdx);
-				}
-			}
-			if (!data.vertices.empty()) found = true;
-		}
+		snapshot.mesh = obj->GetSharedCPUMeshData(); // Shared, copied only if the scale bake runs
+		snapshot.found = true;
+	}
+	// 2. Fallback to primitive data if it matches standard names
+	else if (selectedName.find("Plane") != std::string::npos) { snapshot.primitive = Primitive::Plane; snapshot.found = true; }
+	else if (selectedName.find("Sphere") != std::string::npos) { snapshot.primitive = Primitive::Sphere; snapshot.found = true; }
+	else if (selectedName.find("Cube") != std::string::npos) { snapshot.primitive = Primitive::Cube; snapshot.found = true; }
+	// 3. Extract from Model if available (for loaded assets). Merged here because the model
+	// may be unloaded while the graph runs in the background.
+	else if (obj->GetModel() && !obj->GetModel()->GetMeshDataList().empty())
+	{
+		const auto& meshes = obj->GetModel()->GetMeshDataList();
+		MeshData& merged = snapshot.mesh.Write();
+		for (const auto& m : meshes)
+			merged.Append(m);
+		if (!merged.IsEmpty()) snapshot.found = true;
 	}
 
-	if (found) {
-		glm::vec3 scale = objects[selectedIndex]->GetTransform().GetScale();
-		if (scale != glm::vec3(1.0f))
-		{
-			for (size_t i = 0; i < data.vertices.size(); i += 14)
-			{
-				data.vertices[i] *= scale.x;
-				data.vertices[i + 1] *= scale.y;
-				data.vertices[i + 2] *= scale.z;
-			}
-		}
-		outputs[0].data.meshData = data;
-		outputs[0].data.sourceObjectName = selectedName;
-
-		// Propagate transform data so downstream nodes can handle scale/restore
-		TransformData t;
-		t.position = objects[selectedIndex]->GetTransform().GetPosition();
-		t.rotation = objects[selectedIndex]->GetTransform().GetRotation();
-		t.scale = objects[selectedIndex]->GetTransform().GetScale();
-		outputs[0].data.transforms.push_back(t);
+	// Transform data lets downstream nodes handle scale/restore
+	snapshot.transform.position = obj->GetTransform().GetPosition();
+	snapshot.transform.rotation = obj->GetTransform().GetRotation();
+	snapshot.transform.scale = obj->GetTransform().GetScale();
+}
+
+void SceneInputNode::Execute()
+{
+	outputs[0].data.Clear();
+	outputs[0].data.type = PinDataType::Mesh;
+
+	if (!snapshot.found) return;
+
+	CowPtr<MeshData> data = snapshot.mesh;
+	switch (snapshot.primitive)
+	{
+	case Primitive::Plane: data = PrimitiveGenerator::GetPlaneData(); break;
+	case Primitive::Sphere: data = PrimitiveGenerator::GetSphereData(); break;
+	case Primitive::Cube: data = PrimitiveGenerator::GetCubeData(); break;
+	default: break;
 	}
+
+	glm::vec3 scale = snapshot.transform.scale;
+	if (scale != glm::vec3(1.0f))
+	{
+		MeshData& scaled = data.Write();
+		for (glm::vec3& p : scaled.positions)
+			p *= scale;
+	}
+	outputs[0].data.meshData = data;
+	outputs[0].data.sourceObjectName = selectedName;
+
+	// Propagate transform data so downstream nodes can handle scale/restore
+	outputs[0].data.transforms.Write().push_back(snapshot.transform);
 }
@@ -14,7 +14,10 @@ public:
 	SceneInputNode(NodeGraph& graph);
 
 	void RenderContent(SceneManager* scene) override;
-	void Execute(SceneManager& scene) override;
+	void Execute() override;
+	GraphNode* Clone() const override { return new SceneInputNode(*this); }
+	void CheckSceneChanges(SceneManager& scene) override;
+	void PrepareExecute(SceneManager& scene) override;
 
 	std::string GetSelectedName() const { return selectedName; }
 	int GetSelectedIndex() const { return selectedIndex; }
@@ -23,9 +26,42 @@ public:
 	{
 		selectedIndex = index;
 		selectedName = name;
+		MarkDirty();
 	}
 
 private:
 	int selectedIndex = -1;
 	std::string selectedName = "(none)";
+
+	// Snapshot of the source object taken at the last execution, used to detect outside edits.
+	// Mesh write-backs from Output nodes are deliberately not part of it, otherwise every
+	// "Same As Input" graph would invalidate itself on each run.
+	struct SourceState
+	{
+		const GameObject* object = nullptr;
+		const Model* model = nullptr;
+		glm::vec3 position = glm::vec3(0.0f);
+		glm::vec3 rotation = glm::vec3(0.0f);
+		glm::vec3 scale = glm::vec3(1.0f);
+
+		bool operator==(const SourceState& o) const
+		{
+			return object == o.object && model == o.model &&
+				position == o.position && rotation == o.rotation && scale == o.scale;
+		}
+	};
+	SourceState lastSource;
+
+	SourceState CaptureSource(SceneManager& scene) const;
+
+	// Source data captured on the UI thread by PrepareExecute; Execute only reads this
+	enum class Primitive { None, Plane, Sphere, Cube };
+	struct SourceSnapshot
+	{
+		bool found = false;
+		CowPtr<MeshData> mesh;                 // Custom or model mesh
+		Primitive primitive = Primitive::None; // Primitives are regenerated on the worker instead
+		TransformData transform;
+	};
+	SourceSnapshot snapshot;
 };
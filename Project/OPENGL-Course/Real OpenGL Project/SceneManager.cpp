@@ -48,25 +48,110 @@ void SceneManager::RemoveObject(const std::string& name)
 	}
 }
 
+void SceneManager::AddObjects(const std::vector<GameObject*>& objs, GameObject* parent, unsigned int spawnOwner)
+{
+	if (objs.empty()) return;
+
+	if (parent)
+	{
+		// Same math as GameObject::SetParent, with the parent's inverse computed once per batch
+		glm::mat4 pMat = parent->GetWorldMatrix();
+		glm::mat4 pMatNoScale = pMat;
+		pMatNoScale[0] = glm::normalize(pMatNoScale[0]);
+		pMatNoScale[1] = glm::normalize(pMatNoScale[1]);
+		pMatNoScale[2] = glm::normalize(pMatNoScale[2]);
+		glm::mat4 invParent = glm::inverse(pMat);
+		glm::mat4 invParentNoScale = glm::inverse(pMatNoScale);
+
+		for (auto* obj : objs) {
+			if (!obj) continue;
+			glm::mat4 world = obj->GetTransform().GetModelMatrix();
+			obj->GetTransform().SetFromMatrix((obj->GetInheritScale() ? invParent : invParentNoScale) * world);
+		}
+		parent->AdoptChildren(objs);
+	}
+
+	objects.reserve(objects.size() + objs.size());
+	for (auto* obj : objs) {
+		if (!obj) continue;
+		obj->SetSpawnOwner(spawnOwner);
+		objects.push_back(obj);
+	}
+}
+
+void SceneManager::RemoveObjects(const std::vector<GameObject*>& objs)
+{
+	std::unordered_set<GameObject*> doomed(objs.begin(), objs.end());
+	doomed.erase(nullptr);
+	DeleteObjectSet(doomed);
+}
+
+int SceneManager::RemoveSpawned(unsigned int spawnOwner)
+{
+	if (spawnOwner == 0) return 0;
+
+	std::unordered_set<GameObject*> doomed;
+	for (auto* obj : objects)
+		if (obj->GetSpawnOwner() == spawnOwner) doomed.insert(obj);
+	return DeleteObjectSet(doomed);
+}
+
+int SceneManager::DeleteObjectSet(std::unordered_set<GameObject*>& doomed)
+{
+	if (doomed.empty()) return 0;
+
+	// Descendants go with their ancestors
+	std::vector<GameObject*> pending(doomed.begin(), doomed.end());
+	while (!pending.empty()) {
+		GameObject* obj = pending.back();
+		pending.pop_back();
+		for (auto* child : obj->GetChildren())
+			if (doomed.insert(child).second) pending.push_back(child);
+	}
+
+	// Detach from every affected parent in one pass each, so the destructors have nothing left to scan
+	std::unordered_set<GameObject*> parents;
+	for (auto* obj : doomed)
+		if (obj->GetParent()) parents.insert(obj->GetParent());
+	for (auto* p : parents)
+		p->RemoveChildren(doomed);
+
+	// Compact the object list, remembering where survivors moved for the selection
+	std::vector<int> newIndex(objects.size(), -1);
+	int write = 0;
+	for (int i = 0; i < (int)objects.size(); i++) {
+		if (doomed.count(objects[i])) continue;
+		newIndex[i] = write;
+		objects[write++] = objects[i];
+	}
+	int removed = (int)objects.size() - write;
+	objects.resize(write);
+
+	std::vector<int> newSelection;
+	for (int selIdx : selectedObjectIndices) {
+		if (selIdx >= 0 && selIdx < (int)newIndex.size() && newIndex[selIdx] >= 0)
+			newSelection.push_back(newIndex[selIdx]);
+	}
+	selectedObjectIndices = newSelection;
+	if (selectedObjectIndices.empty()) activeDragAxis = 0;
+
+	for (auto* obj : doomed) delete obj;
+	return removed;
+}
+
 void SceneManager::DeleteSelectedObjects()
 {
 	if (selectedObjectIndices.empty()) return;
 
-	// Collect objects to delete
-	std::vector<GameObject*> toDelete;
+	// Collect objects to delete (children of selected objects go with them)
+	std::unordered_set<GameObject*> toDelete;
 	for (int idx : selectedObjectIndices) {
 		if (idx >= 0 && idx < (int)objects.size()) {
-			toDelete.push_back(objects[idx]);
+			toDelete.insert(objects[idx]);
 		}
 	}
 
-	for (auto* obj : toDelete) {
-		// Re-verify object exists as it might have been deleted as a child of a previous selection
-		auto it = std::find(objects.begin(), objects.end(), obj);
-		if (it != objects.end()) {
-			DeleteGameObject((int)(it - objects.begin()));
-		}
-	}
+	DeleteObjectSet(toDelete);
 	ClearSelection();
 }
 
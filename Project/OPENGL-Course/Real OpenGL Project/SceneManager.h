@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <string>
+#include <unordered_set>
 #include <filesystem>
 #include <GL/glew.h>
 #include <glm/glm.hpp>
@@ -25,6 +26,16 @@ public:
 	GameObject* FindObject(const std::string& name);
 	std::vector<GameObject*>& GetObjects() { return objects; }
 
+	// Bulk add: optionally parents the (parentless) objects under 'parent' keeping their world pose,
+	// inverting the parent matrix once for the whole batch, and tags them with 'spawnOwner'
+	void AddObjects(const std::vector<GameObject*>& objs, GameObject* parent = nullptr, unsigned int spawnOwner = 0);
+	// Bulk delete of the given objects and their descendants in a single pass over the scene
+	void RemoveObjects(const std::vector<GameObject*>& objs);
+
+	// Spawn ownership: a generator takes a handle, tags what it spawns, and later drops it all at once
+	unsigned int CreateSpawnHandle() { return nextSpawnHandle++; }
+	int RemoveSpawned(unsigned int spawnOwner); // Returns the number of objects deleted
+
 	// ========== Light Management ==========
 	void AddLight(LightObject* light);
 	std::vector<LightObject*>& GetLights() { return lights; }
@@ -94,6 +105,11 @@ private:
 	std::vector<int> selectedObjectIndices; // Ordered by selection time, last is primary
 	std::vector<int> selectedLightIndices;
 
+	unsigned int nextSpawnHandle = 1; // 0 means "not spawned"
+
+	// Deletes every object in 'doomed' (plus descendants), compacting 'objects' and the selection once
+	int DeleteObjectSet(std::unordered_set<GameObject*>& doomed);
+
 	Texture* defaultTexture = nullptr;
 	Material* defaultMaterial = nullptr;
 
@@ -1,12 +1,15 @@
 #version 330
 
 layout (location = 0) in vec3 pos;
+layout (location = 5) in mat4 instanceModel;
 
 //world space in orthogonal light
 uniform mat4 model;
 uniform mat4 directionalLightTransform;
+uniform bool useInstancing;
 
 void main()
 {
-	gl_Position = directionalLightTransform * model * vec4(pos, 1.0);
+	mat4 world = useInstancing ? instanceModel : model;
+	gl_Position = directionalLightTransform * world * vec4(pos, 1.0);
 }
@@ -3,7 +3,7 @@
 layout (location = 0) in vec3 pos;
 layout (location = 1) in vec2 tex;
 layout (location = 2) in vec3 norm;
-layout (location = 3) in vec3 tangent;
+layout (location = 3) in vec4 tangent;
 layout (location = 4) in vec3 bitangent;
 
 out vec3 FragPos;
@@ -25,7 +25,7 @@ void main()
     TexCoord = tex;
     
     // TBN matrix for normal mapping
-    vec3 T = normalize(normalMatrix * tangent);
+    vec3 T = normalize(normalMatrix * tangent.xyz);
     vec3 N = normalize(Normal);
     T = normalize(T - dot(T, N) * N); // Re-orthogonalize
     vec3 B = cross(N, T);
@@ -1,11 +1,14 @@
 #version 330
 
 layout (location = 0) in vec3 pos;
+layout (location = 5) in mat4 instanceModel;
 
 uniform mat4 model;
+uniform bool useInstancing;
 
 void main()
 {
 	// just set the position in the world so that the geometry shader can pick it up
-	gl_Position = model * vec4(pos, 1.0);
+	mat4 world = useInstancing ? instanceModel : model;
+	gl_Position = world * vec4(pos, 1.0);
 }
\ No newline at end of file
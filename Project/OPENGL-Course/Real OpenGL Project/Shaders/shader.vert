@@ -3,8 +3,9 @@
 layout (location = 0) in vec3 pos;
 layout (location = 1) in vec2 tex;
 layout (location = 2) in vec3 norm;
-layout (location = 3) in vec3 tangent;
-layout (location = 4) in vec3 bitangent;
+layout (location = 3) in vec4 tangent;   // w = handedness (1.0 for the 14-float layout)
+layout (location = 4) in vec3 bitangent; // (0,0,0) for compact meshes, rebuilt below
+layout (location = 5) in mat4 instanceModel; // per-instance world matrix (locations 5-8)
 
 out vec4 vertex_color;
 out vec2 TexCoord;
@@ -23,24 +24,28 @@ uniform mat4 model;
 uniform mat4 projection;
 uniform mat4 view;
 uniform mat4 directionalLightTransform;
+uniform bool useInstancing;
 
 
 void main()
 {
-	gl_Position = projection * view * model * vec4(pos, 1.0);
-	DirectionalLightSpacePos = directionalLightTransform * model * vec4(pos, 1.0f);
+	mat4 world = useInstancing ? instanceModel : model;
+
+	gl_Position = projection * view * world * vec4(pos, 1.0);
+	DirectionalLightSpacePos = directionalLightTransform * world * vec4(pos, 1.0f);
 
 	vertex_color = vec4(clamp(pos, 0.0f, 1.0f), 1.0f);
 	
 	TexCoord = tex;
 	
-	Normal = mat3(transpose(inverse(model))) * norm;
+	Normal = mat3(transpose(inverse(world))) * norm;
 	
-	FragPos = (model * vec4(pos, 1.0)).xyz; 
+	FragPos = (world * vec4(pos, 1.0)).xyz; 
 
 	// Transform TBN vectors to world space for normal mapping
-	mat3 normalMatrix = mat3(transpose(inverse(model)));
-	TangentWorld = normalize(normalMatrix * tangent);
-	BitangentWorld = normalize(normalMatrix * bitangent);
+	mat3 normalMatrix = mat3(transpose(inverse(world)));
+	vec3 B = dot(bitangent, bitangent) > 0.0 ? bitangent : cross(norm, tangent.xyz) * tangent.w;
+	TangentWorld = normalize(normalMatrix * tangent.xyz);
+	BitangentWorld = normalize(normalMatrix * B);
 	NormalWorld = normalize(normalMatrix * norm);
 }
\ No newline at end of file
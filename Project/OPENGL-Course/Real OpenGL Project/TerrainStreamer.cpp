@@ -0,0 +1,332 @@
+#include "TerrainStreamer.h"
+#include "Mesh.h"
+#include "ThreadPool.h"
+#include "imgui.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cmath>
+
+TerrainStreamer::TerrainStreamer()
+{
+	noiseSnapshot = std::make_shared<PerlinNoiseGenerator>(noise);
+}
+
+TerrainStreamer::~TerrainStreamer()
+{
+	WaitForJobs();
+	Clear();
+}
+
+void TerrainStreamer::WaitForJobs()
+{
+	std::unique_lock<std::mutex> lock(jobsMutex);
+	jobsDone.wait(lock, [this] { return jobsInFlight == 0; });
+}
+
+void TerrainStreamer::Clear()
+{
+	for (auto& entry : chunks)
+		delete entry.second.mesh;
+	chunks.clear();
+
+	// Results of jobs still running are dropped by the version check
+	settingsVersion++;
+	std::lock_guard<std::mutex> lock(resultsMutex);
+	results.clear();
+}
+
+void TerrainStreamer::InvalidateAll()
+{
+	// Keep drawing the old meshes until their replacements arrive
+	settingsVersion++;
+	noiseSnapshot = std::make_shared<PerlinNoiseGenerator>(noise);
+	for (auto& entry : chunks)
+	{
+		entry.second.lod = -1;
+		entry.second.pending = false;
+	}
+}
+
+int TerrainStreamer::GetLoadedChunkCount() const
+{
+	int count = 0;
+	for (auto& entry : chunks)
+		if (entry.second.mesh) count++;
+	return count;
+}
+
+int TerrainStreamer::LodFor(int cx, int cz, const glm::ivec2& cameraChunk) const
+{
+	int ring = std::max(std::abs(cx - cameraChunk.x), std::abs(cz - cameraChunk.y));
+	return std::min(lodCount - 1, ring / std::max(1, lodRingWidth));
+}
+
+int TerrainStreamer::SeamsFor(int cx, int cz, int lod, const glm::ivec2& cameraChunk) const
+{
+	// Edges: 0 = -X, 1 = +X, 2 = -Z, 3 = +Z. Only coarser neighbours matter; the finer side stitches.
+	static const int dx[4] = { -1, 1, 0, 0 };
+	static const int dz[4] = { 0, 0, -1, 1 };
+	int seams = 0;
+	for (int e = 0; e < 4; e++)
+	{
+		int delta = LodFor(cx + dx[e], cz + dz[e], cameraChunk) - lod;
+		if (delta > 0) seams |= std::min(delta, 3) << (e * 2);
+	}
+	return seams;
+}
+
+void TerrainStreamer::Update(const glm::vec3& cameraPos)
+{
+	if (!enabled)
+	{
+		if (!chunks.empty()) Clear();
+		return;
+	}
+
+	glm::ivec2 cameraChunk((int)std::floor(cameraPos.x / chunkSize), (int)std::floor(cameraPos.z / chunkSize));
+
+	// 1. Adopt finished chunks, a few per frame so uploads never stall the frame
+	std::vector<ChunkResult> ready;
+	{
+		std::lock_guard<std::mutex> lock(resultsMutex);
+		int take = std::min((int)results.size(), maxUploadsPerFrame);
+		ready.assign(std::make_move_iterator(results.begin()), std::make_move_iterator(results.begin() + take));
+		results.erase(results.begin(), results.begin() + take);
+	}
+	for (auto& result : ready)
+	{
+		auto it = chunks.find(result.key);
+		if (it == chunks.end() || result.settingsVersion != settingsVersion) continue;
+
+		Chunk& chunk = it->second;
+		if (!chunk.mesh) chunk.mesh = new Mesh();
+		result.mesh.UploadTo(chunk.mesh);
+		chunk.lod = result.lod;
+		chunk.seams = result.seams;
+		chunk.pending = false;
+	}
+
+	// 2. Evict chunks outside the radius (one chunk of slack so the border does not thrash)
+	for (auto it = chunks.begin(); it != chunks.end();)
+	{
+		int ring = std::max(std::abs(KeyX(it->first) - cameraChunk.x), std::abs(KeyZ(it->first) - cameraChunk.y));
+		if (ring > viewRadius + 1)
+		{
+			delete it->second.mesh;
+			it = chunks.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	// 3. Schedule missing or out-of-date chunks, nearest first
+	if (ringOffsetsRadius != viewRadius)
+	{
+		ringOffsets.clear();
+		for (int z = -viewRadius; z <= viewRadius; z++)
+			for (int x = -viewRadius; x <= viewRadius; x++)
+				ringOffsets.push_back(glm::ivec2(x, z));
+		std::stable_sort(ringOffsets.begin(), ringOffsets.end(), [](const glm::ivec2& a, const glm::ivec2& b)
+		{
+			return a.x * a.x + a.y * a.y < b.x * b.x + b.y * b.y;
+		});
+		ringOffsetsRadius = viewRadius;
+	}
+
+	for (const glm::ivec2& offset : ringOffsets)
+	{
+		{
+			std::lock_guard<std::mutex> lock(jobsMutex);
+			if (jobsInFlight >= maxJobsInFlight) break;
+		}
+
+		int cx = cameraChunk.x + offset.x;
+		int cz = cameraChunk.y + offset.y;
+		int lod = LodFor(cx, cz, cameraChunk);
+		int seams = SeamsFor(cx, cz, lod, cameraChunk);
+
+		long long key = MakeKey(cx, cz);
+		Chunk& chunk = chunks[key];
+		if (chunk.pending || (chunk.lod == lod && chunk.seams == seams)) continue;
+
+		chunk.pending = true;
+		Schedule(key, lod, seams);
+	}
+}
+
+void TerrainStreamer::Schedule(long long key, int lod, int seams)
+{
+	{
+		std::lock_guard<std::mutex> lock(jobsMutex);
+		jobsInFlight++;
+	}
+
+	std::shared_ptr<const PerlinNoiseGenerator> snapshot = noiseSnapshot;
+	unsigned int version = settingsVersion;
+	float size = chunkSize;
+	int resolution = std::max(2, (1 << resolutionLog2) >> lod);
+
+	ThreadPool::Get().Submit([this, snapshot, key, lod, seams, version, size, resolution]()
+	{
+		ChunkResult result;
+		result.key = key;
+		result.lod = lod;
+		result.seams = seams;
+		result.settingsVersion = version;
+		result.mesh = BuildChunk(*snapshot, KeyX(key), KeyZ(key), size, resolution, seams);
+
+		{
+			std::lock_guard<std::mutex> lock(resultsMutex);
+			results.push_back(std::move(result));
+		}
+
+		std::lock_guard<std::mutex> lock(jobsMutex);
+		jobsInFlight--;
+		jobsDone.notify_all();
+	});
+}
+
+MeshData TerrainStreamer::BuildChunk(const PerlinNoiseGenerator& noise, int cx, int cz, float chunkSize,
+	int resolution, int seams)
+{
+	// Heights with a one-sample apron, so border normals use the same central differences as the
+	// neighbouring chunk and shading is continuous across chunks.
+	// World coordinates are (global sample index) * step: the step is chunkSize / 2^n, so chunks of any
+	// LOD compute bit-identical coordinates (and heights) for the points they share.
+	float step = chunkSize / (float)resolution;
+	glm::vec2 origin((float)cx * chunkSize, (float)cz * chunkSize);
+	int samples = resolution + 1;
+	int baseX = cx * resolution - 1;
+	int baseZ = cz * resolution - 1;
+
+	HeightfieldData field;
+	field.Resize(samples + 2, samples + 2, origin - glm::vec2(step), glm::vec2(chunkSize + 2.0f * step));
+	std::vector<float> xs(samples + 2), zs(samples + 2);
+	for (int z = 0; z < samples + 2; z++)
+	{
+		for (int x = 0; x < samples + 2; x++)
+		{
+			xs[x] = (float)(baseX + x) * step;
+			zs[x] = (float)(baseZ + z) * step;
+		}
+		noise.SampleHeights(xs.data(), zs.data(), &field.At(0, z), samples + 2);
+	}
+
+	// Positions come from a copy whose edges are snapped to coarser neighbours: every sample between
+	// two coarse grid points is replaced by their linear interpolation, which is exactly the edge the
+	// coarser chunk draws. Normals keep using the unsnapped field.
+	PooledVector<float> heights((size_t)samples * samples);
+	for (int z = 0; z < samples; z++)
+		for (int x = 0; x < samples; x++)
+			heights[(size_t)z * samples + x] = field.At(x + 1, z + 1);
+
+	for (int e = 0; e < 4; e++)
+	{
+		int delta = (seams >> (e * 2)) & 3;
+		if (delta == 0) continue;
+
+		int coarse = std::min(1 << delta, resolution);
+		for (int i = 0; i < samples; i++)
+		{
+			int r = i % coarse;
+			if (r == 0) continue;
+
+			int a = i - r, b = std::min(i - r + coarse, samples - 1);
+			float t = (float)r / (float)(b - a);
+			// Edge sample i as (x, z) in the chunk grid
+			auto index = [&](int k) -> size_t
+			{
+				switch (e)
+				{
+				case 0: return (size_t)k * samples;                   // x = 0
+				case 1: return (size_t)k * samples + (samples - 1);   // x = max
+				case 2: return (size_t)k;                             // z = 0
+				default: return (size_t)(samples - 1) * samples + k;  // z = max
+				}
+			};
+			heights[index(i)] = heights[index(a)] + (heights[index(b)] - heights[index(a)]) * t;
+		}
+	}
+
+	MeshData mesh;
+	VertexWriter w = mesh.AppendVertices(samples * samples);
+	for (int z = 0; z < samples; z++)
+	{
+		for (int x = 0; x < samples; x++)
+		{
+			int v = z * samples + x;
+			glm::vec2 slope = field.GetSlope(x + 1, z + 1);
+			w.positions[v] = glm::vec3((float)(baseX + 1 + x) * step, heights[v], (float)(baseZ + 1 + z) * step);
+			w.uvs[v] = glm::vec2((float)x / (float)resolution, (float)z / (float)resolution);
+			w.normals[v] = glm::normalize(glm::vec3(-slope.x, 1.0f, -slope.y));
+			w.tangents[v] = glm::normalize(glm::vec3(1.0f, slope.x, 0.0f));
+			w.bitangents[v] = glm::normalize(glm::vec3(0.0f, slope.y, 1.0f));
+		}
+	}
+
+	unsigned int* idx = mesh.AppendIndices(resolution * resolution * 6);
+	for (int z = 0; z < resolution; z++)
+	{
+		for (int x = 0; x < resolution; x++)
+		{
+			unsigned int topLeft = z * samples + x;
+			unsigned int topRight = topLeft + 1;
+			unsigned int bottomLeft = (z + 1) * samples + x;
+			unsigned int bottomRight = bottomLeft + 1;
+
+			*idx++ = topLeft; *idx++ = bottomLeft; *idx++ = topRight;
+			*idx++ = topRight; *idx++ = bottomLeft; *idx++ = bottomRight;
+		}
+	}
+	return mesh;
+}
+
+void TerrainStreamer::Render(GLint uniformModel)
+{
+	if (!enabled || chunks.empty()) return;
+
+	glm::mat4 identity(1.0f);
+	glUniformMatrix4fv(uniformModel, 1, GL_FALSE, glm::value_ptr(identity));
+	for (auto& entry : chunks)
+		if (entry.second.mesh) entry.second.mesh->RenderMesh();
+}
+
+void TerrainStreamer::RenderUI(bool* open)
+{
+	if (!*open) return;
+
+	if (ImGui::Begin("Terrain Streaming", open))
+	{
+		ImGui::Checkbox("Enabled", &enabled);
+
+		bool rebuild = false;
+		rebuild |= ImGui::DragFloat("Chunk Size", &chunkSize, 1.0f, 4.0f, 1024.0f);
+		rebuild |= ImGui::SliderInt("Chunk Res (2^n)", &resolutionLog2, 3, 8);
+		rebuild |= ImGui::SliderInt("LOD Levels", &lodCount, 1, 6);
+		rebuild |= ImGui::SliderInt("LOD Ring Width", &lodRingWidth, 1, 8);
+		ImGui::SliderInt("View Radius", &viewRadius, 1, 32);
+		ImGui::SliderInt("Uploads / Frame", &maxUploadsPerFrame, 1, 32);
+		ImGui::SliderInt("Jobs In Flight", &maxJobsInFlight, 1, 64);
+
+		ImGui::Separator();
+		if (noise.RenderUI()) rebuild = true;
+
+		if (rebuild)
+		{
+			// LOD 0 resolution >> (levels - 1) must stay at least 2 quads
+			lodCount = std::min(lodCount, resolutionLog2);
+			InvalidateAll();
+		}
+
+		ImGui::Separator();
+		int pending;
+		{
+			std::lock_guard<std::mutex> lock(jobsMutex);
+			pending = jobsInFlight;
+		}
+		ImGui::Text("Chunks: %d loaded, %d generating", GetLoadedChunkCount(), pending);
+	}
+	ImGui::End();
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <unordered_map>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "MeshData.h"
+#include "PerlinNoiseGenerator.h"
+
+class Mesh;
+
+// Streams noise terrain in square chunks around the camera.
+// Chunks are generated on the thread pool (nearest first, a bounded number in flight) and uploaded
+// a few per frame on the GL thread. Resolution halves per LOD ring; edges facing a coarser neighbour
+// are snapped to its grid so levels meet without cracks. Chunks leaving the view radius are evicted,
+// so memory stays bounded however far the camera travels.
+class TerrainStreamer
+{
+public:
+	TerrainStreamer();
+	~TerrainStreamer();
+
+	// GL thread, once per frame: adopt finished chunks, evict far ones, schedule missing ones
+	void Update(const glm::vec3& cameraPos);
+
+	// Draw loaded chunks (world-space vertices, identity model matrix)
+	void Render(GLint uniformModel);
+
+	void RenderUI(bool* open);
+
+	// Drop every chunk (GL thread); in-flight jobs finish and are discarded
+	void Clear();
+
+	bool IsEnabled() const { return enabled; }
+	int GetLoadedChunkCount() const;
+
+private:
+	struct Chunk
+	{
+		Mesh* mesh = nullptr;
+		int lod = -1;        // LOD of the uploaded mesh (-1: none / stale)
+		int seams = 0;       // Neighbour LOD deltas the mesh was stitched for (2 bits per edge)
+		bool pending = false;
+	};
+
+	struct ChunkResult
+	{
+		long long key;
+		int lod;
+		int seams;
+		unsigned int settingsVersion;
+		MeshData mesh;
+	};
+
+	std::unordered_map<long long, Chunk> chunks;
+
+	// Finished jobs waiting for upload
+	std::mutex resultsMutex;
+	std::vector<ChunkResult> results;
+
+	// In-flight job count (jobs reference this object, so the destructor waits for zero)
+	std::mutex jobsMutex;
+	std::condition_variable jobsDone;
+	int jobsInFlight = 0;
+
+	// Noise settings edited by the UI, and the immutable snapshot shared by running jobs
+	PerlinNoiseGenerator noise;
+	std::shared_ptr<const PerlinNoiseGenerator> noiseSnapshot;
+	unsigned int settingsVersion = 0;
+
+	// Settings
+	bool enabled = false;
+	float chunkSize = 32.0f;    // World units per chunk side
+	int resolutionLog2 = 6;     // LOD 0 chunks have 2^n quads per side
+	int viewRadius = 8;         // In chunks (Chebyshev distance)
+	int lodCount = 4;
+	int lodRingWidth = 2;       // Chunks per LOD ring
+	int maxUploadsPerFrame = 4;
+	int maxJobsInFlight = 8;
+
+	// Chunk offsets within the view radius, nearest first (rebuilt when the radius changes)
+	std::vector<glm::ivec2> ringOffsets;
+	int ringOffsetsRadius = -1;
+
+	static long long MakeKey(int cx, int cz) { return ((long long)cx << 32) | (unsigned int)cz; }
+	static int KeyX(long long key) { return (int)(key >> 32); }
+	static int KeyZ(long long key) { return (int)(unsigned int)(key & 0xffffffff); }
+
+	int LodFor(int cx, int cz, const glm::ivec2& cameraChunk) const;
+	int SeamsFor(int cx, int cz, int lod, const glm::ivec2& cameraChunk) const;
+	void Schedule(long long key, int lod, int seams);
+	void InvalidateAll();
+	void WaitForJobs();
+
+	// Worker side: sample, stitch and triangulate one chunk
+	static MeshData BuildChunk(const PerlinNoiseGenerator& noise, int cx, int cz, float chunkSize,
+		int resolution, int seams);
+};
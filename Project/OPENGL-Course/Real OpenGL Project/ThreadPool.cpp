@@ -0,0 +1,115 @@
+#include "ThreadPool.h"
+#include <memory>
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+	: stopping(false)
+{
+	if (threadCount == 0)
+	{
+		// Leave one core for the render/UI thread
+		unsigned int hw = std::thread::hardware_concurrency();
+		threadCount = hw > 1 ? hw - 1 : 1;
+	}
+
+	workers.reserve(threadCount);
+	for (unsigned int i = 0; i < threadCount; i++)
+		workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		stopping = true;
+	}
+	queueCondition.notify_all();
+
+	for (auto& worker : workers)
+		if (worker.joinable()) worker.join();
+}
+
+ThreadPool& ThreadPool::Get()
+{
+	static ThreadPool instance;
+	return instance;
+}
+
+void ThreadPool::Submit(std::function<void()> job)
+{
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		jobs.push(std::move(job));
+	}
+	queueCondition.notify_one();
+}
+
+void ThreadPool::WorkerLoop()
+{
+	while (true)
+	{
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			queueCondition.wait(lock, [this] { return stopping || !jobs.empty(); });
+			if (stopping && jobs.empty()) return;
+
+			job = std::move(jobs.front());
+			jobs.pop();
+		}
+		job();
+	}
+}
+
+void ThreadPool::ParallelFor(int begin, int end, int grainSize, const std::function<void(int, int)>& body)
+{
+	if (end <= begin) return;
+	if (grainSize < 1) grainSize = 1;
+
+	int chunkCount = (end - begin + grainSize - 1) / grainSize;
+	if (chunkCount == 1 || workers.empty())
+	{
+		body(begin, end);
+		return;
+	}
+
+	// Chunks are claimed from a shared counter, so helpers that start late simply find nothing left.
+	// Completion is tracked per chunk (not per helper job), which means the caller never waits on
+	// a job that is still sitting in the queue behind it.
+	struct SharedState
+	{
+		std::atomic<int> nextChunk{ 0 };
+		std::atomic<int> doneChunks{ 0 };
+		std::mutex doneMutex;
+		std::condition_variable doneCondition;
+	};
+	auto state = std::make_shared<SharedState>();
+
+	auto runChunks = [state, begin, end, grainSize, chunkCount, &body]()
+	{
+		while (true)
+		{
+			int chunk = state->nextChunk.fetch_add(1);
+			if (chunk >= chunkCount) return;
+
+			int chunkBegin = begin + chunk * grainSize;
+			int chunkEnd = std::min(chunkBegin + grainSize, end);
+			body(chunkBegin, chunkEnd);
+
+			if (state->doneChunks.fetch_add(1) + 1 == chunkCount)
+			{
+				std::lock_guard<std::mutex> lock(state->doneMutex);
+				state->doneCondition.notify_all();
+			}
+		}
+	};
+
+	int helpers = std::min((int)workers.size(), chunkCount - 1);
+	for (int i = 0; i < helpers; i++)
+		Submit(runChunks);
+
+	runChunks();
+
+	std::unique_lock<std::mutex> lock(state->doneMutex);
+	state->doneCondition.wait(lock, [&state, chunkCount] { return state->doneChunks.load() == chunkCount; });
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+
+// Fixed-size pool of worker threads shared by the procedural generation code.
+// Jobs are plain std::function<void()>; callers handle their own joining.
+class ThreadPool
+{
+public:
+	explicit ThreadPool(unsigned int threadCount = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// Queue a job for execution on a worker thread
+	void Submit(std::function<void()> job);
+
+	// Split [begin, end) into chunks of 'grainSize' and run 'body(chunkBegin, chunkEnd)' in parallel.
+	// The calling thread works on chunks too, so this is safe to call from inside a pool job.
+	void ParallelFor(int begin, int end, int grainSize, const std::function<void(int, int)>& body);
+
+	unsigned int GetThreadCount() const { return (unsigned int)workers.size(); }
+
+	// Global access (created lazily on first use)
+	static ThreadPool& Get();
+
+private:
+	std::vector<std::thread> workers;
+	std::queue<std::function<void()>> jobs;
+	std::mutex queueMutex;
+	std::condition_variable queueCondition;
+	bool stopping;
+
+	void WorkerLoop();
+};